@@ -7,9 +7,14 @@
  * (at your option) any later version.
  */
 
+#include <algorithm>
+#include <limits>
+
 #include "DAGMan.h"
+#include "DAGManMessage.h"
 #include "DAGManScheduler.h"
-#include "PegasusSimulationTimestampTypes.h"
+
+#define NO_SUB_WORKFLOW std::numeric_limits<unsigned long>::max()
 
 XBT_LOG_NEW_DEFAULT_CATEGORY(DAGMan, "Log category for DAGMan");
 
@@ -48,15 +53,19 @@ namespace wrench {
         }
 
         /**
-         * @brief Compare the priority between two workflow tasks
+         * @brief Set whether DAGMan should be woken up by the monitor upon job completions instead of
+         *        periodically polling for completed jobs
          *
-         * @param lhs: pointer to a workflow task
-         * @param rhs: pointer to a workflow task
-         *
-         * @return whether the priority of the left-hand-side workflow tasks is higher
+         * @param event_driven: whether DAGMan waits for monitor notifications
+         * @param coalesce_window: time (in seconds) to wait after a notification so that job completions
+         *                         are processed in batches, as in a HTCondor user log scan
          */
-        bool DAGMan::TaskPriorityComparator::operator()(WorkflowTask *&lhs, WorkflowTask *&rhs) {
-            return lhs->getPriority() > rhs->getPriority();
+        void DAGMan::setEventDriven(bool event_driven, double coalesce_window) {
+            if (coalesce_window < 0) {
+                throw std::invalid_argument("DAGMan::setEventDriven(): coalesce window must be non-negative");
+            }
+            this->event_driven = event_driven;
+            this->coalesce_window = coalesce_window;
         }
 
         /**
@@ -67,6 +76,33 @@ namespace wrench {
          * @throw std::runtime_error
          */
         int DAGMan::main() {
+            try {
+                this->execute();
+            } catch (...) {
+                // the tasks completed so far are recorded before the failure is propagated
+                try {
+                    this->writeOutputFiles();
+                } catch (std::exception &e) {
+                    WRENCH_INFO("Unable to write output files: %s", e.what());
+                }
+                throw;
+            }
+            this->writeOutputFiles();
+
+            WRENCH_INFO("DAGMan Daemon started on host %s terminating", S4U_Simulation::getHostName().c_str());
+
+            this->job_manager.reset();
+            this->data_movement_manager.reset();
+
+            return 0;
+        }
+
+        /**
+         * @brief Execute the workflow, until all tasks have completed or the execution is aborted
+         *
+         * @throw std::runtime_error
+         */
+        void DAGMan::execute() {
             TerminalOutput::setThisProcessLoggingColor(TerminalOutput::COLOR_GREEN);
 
             // Check whether the DAGMan has a deferred start time
@@ -74,17 +110,29 @@ namespace wrench {
 
             WRENCH_INFO("Starting DAGMan on host %s listening on mailbox_name %s",
                         S4U_Simulation::getHostName().c_str(),
-                        this->mailbox_name.c_str());WRENCH_INFO("DAGMan is about to execute a workflow with %lu tasks",
-                                                                this->getWorkflow()->getNumberOfTasks());
+                        this->mailbox_name.c_str());
+            WRENCH_INFO("DAGMan is about to execute a workflow with %lu tasks",
+                        this->getWorkflow()->getNumberOfTasks());
+
+            if (not this->workflow_index) {
+                this->workflow_index = std::make_shared<WorkflowIndex>(this->getWorkflow());
+            }
+            if (not this->job_clustering) {
+                this->job_clustering = std::make_shared<JobClustering>(*this->workflow_index);
+            }
+            this->lifecycle_table = std::make_shared<TaskLifecycleTable>(this->workflow_index->getNumberOfTasks());
+            this->statistics = std::make_shared<DAGManStatistics>();
 
             // starting monitor
-            this->dagman_monitor = std::make_shared<DAGManMonitor>(this->hostname, this->getWorkflow());
+            this->dagman_monitor = std::make_shared<DAGManMonitor>(this->hostname, this->getWorkflow(),
+                                                                   this->event_driven ? this->mailbox_name : "");
+            this->dagman_monitor->setStatistics(this->statistics);
             this->dagman_monitor->simulation = this->simulation;
             this->dagman_monitor->start(dagman_monitor, true, true);
 
             if (not this->energy_scheme.empty()) {
                 // create the energy meter
-                auto power_meter = this->createPowerMeter(this->execution_hosts, 1);
+                this->power_meter = this->createPowerMeter(this->execution_hosts, 1);
             }
 
             // Create a job manager
@@ -96,88 +144,166 @@ namespace wrench {
             dagman_scheduler->setSimulation(this->simulation);
             dagman_scheduler->setDataMovementManager(data_movement_manager);
             dagman_scheduler->setMonitorCallbackMailbox(this->dagman_monitor->getMailbox());
+            dagman_scheduler->setJobClustering(this->workflow_index, this->job_clustering);
+            dagman_scheduler->setPoolSlots(this->pool_slots);
+            dagman_scheduler->setTaskLifecycleTable(this->lifecycle_table);
+            dagman_scheduler->setStatistics(this->statistics);
+            dagman_scheduler->setLocalityAwarePlacement(this->locality_aware_placement);
+            dagman_scheduler->setAsynchronousStageIn(this->asynchronous_stage_in, this->max_concurrent_transfers);
+
+            if (this->throttle.getBootstrapDelay() > 0) {
+                WRENCH_INFO("Sleeping for %.1f seconds to ensure ProcessId uniqueness (DAGMan simulated waiting time)",
+                            this->throttle.getBootstrapDelay());
+                Simulation::sleep(this->throttle.getBootstrapDelay());
+            }
+            WRENCH_INFO("Bootstrapping...");
+
+            unsigned long num_tasks = this->workflow_index->getNumberOfTasks();
+            auto &categories = this->workflow_index->getCategories();
+            this->ready_queue.reset(num_tasks, categories.getNumberOfTypes());
+            this->throttle.setCategories(categories);
+            this->scheduled_tasks.assign(num_tasks, false);
+            this->pending_parents.resize(num_tasks);
+            this->task_sub_workflows.assign(num_tasks, NO_SUB_WORKFLOW);
+            this->indexSubWorkflowNodes(0);
+            this->completed_tasks = 0;
+            this->pending_cluster_tasks.resize(this->job_clustering->getNumberOfClusters());
+            for (unsigned long cluster = 0; cluster < this->job_clustering->getNumberOfClusters(); cluster++) {
+                this->pending_cluster_tasks[cluster] = this->job_clustering->getClusterTasks(cluster).size();
+            }
 
-            WRENCH_INFO("Sleeping for 3 seconds to ensure ProcessId uniqueness (DAGMan simulated waiting time)");
-            Simulation::sleep(3.0);WRENCH_INFO("Bootstrapping...");
-
-            while (true) {
-                // DAGMan only runs tasks up to the current level
-                std::vector<WorkflowTask *> dagman_ready_tasks;
-
-                for (auto task : this->getWorkflow()->getReadyTasks()) {
-                    // set task priority according to DAGMan rules for parent tasks
-                    long max_priority = task->getPriority();
-                    for (auto parent : task->getWorkflow()->getTaskParents(task)) {
-                        if (parent->getPriority() > max_priority) {
-                            max_priority = parent->getPriority();
-                        }
-                    }
-                    task->setPriority(max_priority);
-                    dagman_ready_tasks.push_back(task);
+            // tasks that are ready from the start
+            for (unsigned long id = 0; id < num_tasks; id++) {
+                this->pending_parents[id] = this->workflow_index->getParents(id).size();
+                if (this->pending_parents[id] == 0) {
+                    this->notifyTaskReady(id);
                 }
+            }
 
-                // sort tasks by priority
-                std::sort(dagman_ready_tasks.begin(), dagman_ready_tasks.end(), TaskPriorityComparator());
-
-                unsigned long submitted_tasks = 0;
-
+            while (true) {
                 std::vector<WorkflowTask *> tasks_to_submit;
+                unsigned long submitted_jobs = 0;
+                bool idle_throttled = false;
+                auto &loop_statistics = this->statistics->loop;
+                loop_statistics.iterations++;
+
+                // sub-workflow nodes are expanded as soon as they are ready (nested nodes may become ready)
+                while (not this->ready_sub_workflows.empty()) {
+                    unsigned long node = this->ready_sub_workflows.back();
+                    this->ready_sub_workflows.pop_back();
+                    this->expandSubWorkflow(node);
+                }
 
-                for (auto it = dagman_ready_tasks.begin(); it != dagman_ready_tasks.end();) {
-                    auto task = *it;
-
-                    if (tasks_to_submit.size() == 5) {
-                        break;
+                if (not this->ready_queue.empty() && not this->throttle.isMaxJobsReached()) {
+                    // DAGMan only runs tasks of a single type at once: the type of the running tasks, or
+                    // the type of the highest priority ready job if no task is running
+                    unsigned int task_id_type = this->current_running_task_type.second == 0
+                                                ? this->ready_queue.getType(this->ready_queue.top())
+                                                : this->current_running_task_type.first;
+                    bool register_type = categories.isRegisterType(task_id_type);
+                    auto scan_start = DAGManStatistics::now();
+                    loop_statistics.type_gated_jobs +=
+                            this->ready_queue.size() - this->ready_queue.getTasks(task_id_type).size();
+
+                    std::vector<unsigned long> ids_to_submit;
+                    unsigned long idle_jobs = this->throttle.getMaxIdle() > 0 ? this->getNumberOfIdleJobs() : 0;
+
+                    // each queue entry is a (possibly clustered) job, identified by its first task. Jobs are
+                    // scanned in priority order by merging the queues of the categories of the type, so that
+                    // the remaining jobs of a full category are skipped at once
+                    std::vector<CategoryCursor> cursors;
+                    for (auto &category_tasks : this->ready_queue.getTasksPerCategory(task_id_type)) {
+                        if (not category_tasks.second.empty()) {
+                            cursors.push_back({category_tasks.first, category_tasks.second.begin(),
+                                               category_tasks.second.size()});
+                        }
                     }
+                    auto cursor_order = [](const CategoryCursor &lhs, const CategoryCursor &rhs) {
+                        return DAGManReadyQueue::EntryComparator()(*rhs.next, *lhs.next);
+                    };
+                    std::make_heap(cursors.begin(), cursors.end(), cursor_order);
+
+                    while (not cursors.empty()) {
+                        std::pop_heap(cursors.begin(), cursors.end(), cursor_order);
+                        auto &cursor = cursors.back();
+                        auto entry = *cursor.next;
+                        unsigned long cluster = this->job_clustering->getTaskCluster(entry.id);
+                        auto cluster_tasks = this->job_clustering->getClusterTasks(cluster);
+                        unsigned int task_category = cursor.category;
+
+                        loop_statistics.scanned_jobs++;
+                        if (this->throttle.isSubmitIntervalFull(submitted_jobs) ||
+                            this->throttle.isMaxJobsReached()) {
+                            loop_statistics.submit_throttled_scans++;
+                            break;
+                        }
+                        if (this->throttle.isMaxIdleReached(idle_jobs)) {
+                            idle_throttled = true;
+                            loop_statistics.idle_throttled_scans++;
+                            break;
+                        }
+                        if (this->throttle.isCategoryFull(task_category)) {
+                            loop_statistics.category_throttled_jobs += cursor.remaining;
+                            cursors.pop_back();
+                            continue;
+                        }
 
-                    // get task ID type
-                    std::string task_id_type = this->getTaskIDType(task->getID());
+                        // the next job of the category is scanned in turn
+                        if (--cursor.remaining == 0) {
+                            cursors.pop_back();
+                        } else {
+                            cursor.next++;
+                            std::push_heap(cursors.begin(), cursors.end(), cursor_order);
+                        }
 
-                    if (this->current_running_task_type.first.empty() ||
-                        this->current_running_task_type.first == task_id_type) {
                         // by default DAGMan only runs a single register job at once
-                        if (task->getID().find("register_local") == 0) {
-                            if (running_register_tasks > 0) {
-                                submitted_tasks++;
-                                dagman_ready_tasks.erase(it);
+                        if (register_type) {
+                            if (this->throttle.getMaxRegisterJobs() > 0 &&
+                                running_register_tasks >= this->throttle.getMaxRegisterJobs()) {
+                                loop_statistics.register_throttled_jobs++;
                                 continue;
                             }
                             running_register_tasks++;
                         }
 
-                        if (this->scheduled_tasks.find(task) == this->scheduled_tasks.end()) {
-                            // update current running task type
-                            if (this->current_running_task_type.first.empty()) {
-                                this->current_running_task_type = std::make_pair(task_id_type, 1);
-                            } else {
-                                this->current_running_task_type.second++;
-                            }
+                        // update current running task type
+                        if (this->current_running_task_type.second == 0) {
+                            this->current_running_task_type = std::make_pair(task_id_type, cluster_tasks.size());
+                        } else {
+                            this->current_running_task_type.second += cluster_tasks.size();
+                        }
 
-                            this->scheduled_tasks.insert(task);
+                        this->idle_clusters.insert(cluster);
+                        this->throttle.notifyJobSubmitted(task_category);
+                        idle_jobs++;
+                        submitted_jobs++;
+                        loop_statistics.submitted_jobs++;
+                        ids_to_submit.push_back(entry.id);
+
+                        for (auto id : cluster_tasks) {
+                            auto task = this->workflow_index->getTask(id);
+                            unsigned long task_level = this->workflow_index->getTopLevel(id);
+
+                            this->scheduled_tasks[id] = true;
                             tasks_to_submit.push_back(task);
-                            dagman_ready_tasks.erase(it);
 
                             // updating number of tasks running per level
-                            if (task->getTopLevel() > this->running_tasks_level.first) {
-                                this->running_tasks_level = std::make_pair(task->getTopLevel(), 1);
+                            if (task_level > this->running_tasks_level.first) {
+                                this->running_tasks_level = std::make_pair(task_level, 1);
 
-                            } else if (task->getTopLevel() == this->running_tasks_level.first) {
+                            } else if (task_level == this->running_tasks_level.first) {
                                 this->running_tasks_level.second++;
                             }
 
-                            // create job submitted event
-                            this->simulation->getOutput().addTimestamp<SimulationTimestampJobSubmitted>(
-                                    new SimulationTimestampJobSubmitted(task));WRENCH_INFO("Submitted task: %s",
-                                                                                           task->getID().c_str());
-
-                        } else {
-                            submitted_tasks++;
-                            dagman_ready_tasks.erase(it);
+                            this->lifecycle_table->recordSubmitted(id);
+                            WRENCH_INFO("Submitted task: %s", task->getID().c_str());
                         }
-                    } else {
-                        submitted_tasks++;
-                        dagman_ready_tasks.erase(it);
                     }
+
+                    for (auto id : ids_to_submit) {
+                        this->ready_queue.remove(id);
+                    }
+                    loop_statistics.scan_wall_time += DAGManStatistics::elapsed(scan_start);
                 }
 
                 // submit tasks
@@ -185,78 +311,501 @@ namespace wrench {
                     // Get the available compute services
                     auto htcondor_services = this->getAvailableComputeServices<ComputeService>();
 
-                    if (htcondor_services.empty()) { WRENCH_INFO("Aborting - No HTCondor services available!");
+                    if (htcondor_services.empty()) {
+                        WRENCH_INFO("Aborting - No HTCondor services available!");
                         break;
                     }
 
                     // Submit pilot jobs
-                    if (this->getPilotJobScheduler()) { WRENCH_INFO("Scheduling pilot jobs...");
+                    if (this->getPilotJobScheduler()) {
+                        WRENCH_INFO("Scheduling pilot jobs...");
                         this->getPilotJobScheduler()->schedulePilotJobs(htcondor_services);
                     }
 
                     // Run ready tasks with defined scheduler implementation
                     WRENCH_INFO("Scheduling tasks...");
                     this->getStandardJobScheduler()->scheduleTasks(htcondor_services, tasks_to_submit);
+                    if (this->power_meter) {
+                        this->power_meter->notifyTasksSubmitted(tasks_to_submit);
+                    }
+                }
+
+                double wait_start = S4U_Simulation::getClock();
+                if (this->event_driven && tasks_to_submit.empty() && this->current_running_task_type.second > 0) {
+                    // nothing else can be submitted until running jobs complete (or, if throttled by the
+                    // number of idle jobs, until idle jobs start running, which is checked at every interval)
+                    this->waitForMonitorNotification(idle_throttled ? this->throttle.getSubmitInterval() : 0);
+                } else {
+                    // simulate timespan between DAGMan status pull for HTCondor
+                    Simulation::sleep(this->throttle.getSubmitInterval());
                 }
+                loop_statistics.wait_simulated_time += S4U_Simulation::getClock() - wait_start;
 
-                // simulate timespan between DAGMan status pull for HTCondor
-                Simulation::sleep(0.1);
-                for (auto standard_job : this->dagman_monitor->getCompletedJobs()) {
-                    for (auto task : standard_job->getTasks()) { WRENCH_INFO("    Task completed: %s",
-                                                                             task->getID().c_str());
+                auto completed_jobs = this->dagman_monitor->getCompletedJobs();
+                auto completion_start = DAGManStatistics::now();
+                if (tasks_to_submit.empty() && completed_jobs.empty()) {
+                    loop_statistics.idle_iterations++;
+                }
+                for (auto standard_job : completed_jobs) {
+                    auto output_storage_service = dagman_scheduler->processJobCompletion(standard_job);
+                    loop_statistics.completed_jobs++;
+                    auto job_tasks = standard_job->getTasks();
+                    if (job_tasks.empty()) {
+                        continue;
+                    }
+
+                    // job-level bookkeeping
+                    unsigned long first_id = this->workflow_index->getTaskIndex(job_tasks.front());
+                    this->idle_clusters.erase(this->job_clustering->getTaskCluster(first_id));
+                    this->throttle.notifyJobCompleted(categories.getTaskCategory(first_id));
+                    if (categories.isRegisterType(categories.getTaskType(first_id))) {
+                        // a register job has completed
+                        this->running_register_tasks--;
+                    }
+
+                    for (auto task : job_tasks) {
+                        WRENCH_INFO("    Task completed: %s", task->getID().c_str());
+                        unsigned long id = this->workflow_index->getTaskIndex(task);
+                        unsigned long task_level = this->workflow_index->getTopLevel(id);
 
                         // update current running task ID type
                         this->current_running_task_type.second -= 1;
-                        if (this->current_running_task_type.second == 0) {
-                            this->current_running_task_type.first = "";
-                        }
 
-                        if (task->getID().find("register_") == 0) {
-                            // a register task has completed
-                            this->running_register_tasks--;
+                        if (this->power_meter) {
+                            this->power_meter->notifyTaskCompleted(task);
                         }
 
                         // notify a task in a specific level has completed
-                        if (task->getTopLevel() > this->running_tasks_level.first) {
+                        if (task_level > this->running_tasks_level.first) {
                             throw std::invalid_argument(
                                     "DAGMan::processEventStandardJobCompletion: Invalid task level");
                         }
-                        if (task->getTopLevel() == this->running_tasks_level.first) {
+                        if (task_level == this->running_tasks_level.first) {
                             this->running_tasks_level.second--;
                         }
 
-                        // create job completion event
-                        this->simulation->getOutput().addTimestamp<SimulationTimestampJobCompletion>(
-                                new SimulationTimestampJobCompletion(task));
+                        this->lifecycle_table->recordCompleted(id);
+                        if (this->trace_sink) {
+                            this->trace_sink->notifyTaskCompleted(task, *this->lifecycle_table);
+                        }
+
+                        // a sub-workflow is complete once all its tasks are
+                        unsigned long node = this->task_sub_workflows[id];
+                        if (node != NO_SUB_WORKFLOW && --this->sub_workflows[node].pending == 0) {
+                            this->completed_sub_workflows.push_back(node);
+                        }
+
+                        // tasks of sub-workflows are recorded as well, so that a resumed sub-workflow only runs
+                        // its remaining tasks
+                        if (this->rescue_dag && not this->rescue_filename.empty()) {
+                            this->rescue_dag->addCompletedTask(
+                                    task, output_storage_service ? output_storage_service->getHostname() : "");
+                        }
+
+                        // children whose parents have all completed become ready
+                        this->completed_tasks++;
+                        for (auto child : this->workflow_index->getChildren(id)) {
+                            if (--this->pending_parents[child] == 0) {
+                                this->notifyTaskReady(child);
+                            }
+                        }
                     }
                 }
 
-                if (this->abort || this->getWorkflow()->isDone()) {
+                loop_statistics.completion_wall_time += DAGManStatistics::elapsed(completion_start);
+
+                if (this->power_meter) {
+                    this->power_meter->update();
+                }
+
+                // completed sub-workflows are released, and their nodes then run as regular jobs
+                for (auto node : this->completed_sub_workflows) {
+                    this->releaseSubWorkflow(node);
+                }
+                this->completed_sub_workflows.clear();
+
+                // stage-in transfers may release jobs waiting for their input files
+                for (auto event : this->dagman_monitor->getFileCopyEvents()) {
+                    if (auto copy_completed = std::dynamic_pointer_cast<FileCopyCompletedEvent>(event)) {
+                        dagman_scheduler->processFileCopyCompletion(copy_completed->file, copy_completed->src,
+                                                                    copy_completed->dst);
+                    } else if (auto copy_failed = std::dynamic_pointer_cast<FileCopyFailedEvent>(event)) {
+                        auto failed_jobs = dagman_scheduler->processFileCopyFailure(
+                                copy_failed->file, copy_failed->src, copy_failed->dst, copy_failed->failure_cause);
+                        for (auto &job_tasks : failed_jobs) {
+                            WRENCH_INFO("A job has failed (one of its input files could not be staged in)");
+                            this->processJobFailure(job_tasks);
+                        }
+                    }
+                }
+
+                if (this->abort || this->completed_tasks == this->workflow_index->getNumberOfTasks()) {
                     break;
                 }
             }
 
+            // the energy consumed after the last change of the host running sets is accounted for
+            if (this->power_meter) {
+                this->power_meter->finish();
+            }
+
             WRENCH_INFO("--------------------------------------------------------");
-            if (this->getWorkflow()->isDone()) { WRENCH_INFO("Workflow execution is complete!");
-            } else { WRENCH_INFO("Workflow execution is incomplete!");
+            if (this->getWorkflow()->isDone()) {
+                WRENCH_INFO("Workflow execution is complete!");
+            } else {
+                WRENCH_INFO("Workflow execution is incomplete!");
             }
+            WRENCH_INFO("Replica cache: %ld hits, %ld misses", dagman_scheduler->getReplicaCache().getHits(),
+                        dagman_scheduler->getReplicaCache().getMisses());
+        }
 
-            WRENCH_INFO("DAGMan Daemon started on host %s terminating", S4U_Simulation::getHostName().c_str());
+        /**
+         * @brief Flush the task trace and write the rescue file (if set), when DAGMan exits
+         *
+         * @throw std::runtime_error
+         */
+        void DAGMan::writeOutputFiles() {
+            if (this->trace_sink) {
+                this->trace_sink->flush();
+            }
 
-            this->job_manager.reset();
-            this->data_movement_manager.reset();
+            if (this->rescue_dag && not this->rescue_filename.empty()) {
+                WRENCH_INFO("Writing rescue file with %ld completed tasks: %s",
+                            this->rescue_dag->getNumberOfCompletedTasks(), this->rescue_filename.c_str());
+                this->rescue_dag->write(this->rescue_filename);
+            }
+        }
 
-            return 0;
+        /**
+         * @brief Account for a task that became ready. Once all tasks of its cluster are ready, the (clustered)
+         *        job is added to the ready queue.
+         *
+         * @param id: the dense ID of a ready workflow task
+         */
+        void DAGMan::notifyTaskReady(unsigned long id) {
+            unsigned long cluster = this->job_clustering->getTaskCluster(id);
+            if (--this->pending_cluster_tasks[cluster] == 0) {
+                this->enqueueReadyJob(cluster);
+            }
+        }
+
+        /**
+         * @brief Add a ready (clustered) job to the ready queue. According to DAGMan rules, a task inherits the
+         *        highest priority among its parents, which is precomputed in the workflow index; a clustered job
+         *        has the highest priority among its tasks.
+         *
+         * @param cluster: the cluster ID of the job
+         */
+        void DAGMan::enqueueReadyJob(unsigned long cluster) {
+            unsigned long leader = this->job_clustering->getClusterLeader(cluster);
+            if (this->scheduled_tasks[leader]) {
+                return;
+            }
+            if (this->sub_workflow_nodes[leader]) {
+                // the node is expanded first, and runs once its sub-workflow has completed
+                this->sub_workflow_nodes[leader] = false;
+                this->ready_sub_workflows.push_back(leader);
+                return;
+            }
+            this->ready_queue.push(leader, this->job_clustering->getClusterPriority(cluster),
+                                   this->workflow_index->getCategories().getTaskType(leader),
+                                   this->workflow_index->getCategories().getTaskCategory(leader));
+        }
+
+        /**
+         * @brief Record which of the tasks indexed since a given dense ID are sub-workflow nodes
+         *
+         * @param first: the dense ID of the first task to check
+         */
+        void DAGMan::indexSubWorkflowNodes(unsigned long first) {
+            unsigned long num_tasks = this->workflow_index->getNumberOfTasks();
+            this->sub_workflow_nodes.resize(num_tasks, false);
+            if (not this->sub_workflow_expander) {
+                return;
+            }
+            for (unsigned long id = first; id < num_tasks; id++) {
+                this->sub_workflow_nodes[id] = this->sub_workflow_expander->isSubWorkflowNode(
+                        this->workflow_index->getTask(id)->getID());
+            }
+        }
+
+        /**
+         * @brief Expand a ready sub-workflow node: its inner workflow is added to the running workflow and
+         *        indexed, and its entry tasks become ready. The DAGMan bookkeeping arrays grow accordingly.
+         *
+         * @param node: the dense ID of the sub-workflow node
+         */
+        void DAGMan::expandSubWorkflow(unsigned long node) {
+            TaskCategoryRegistry::TransformationMap transformations;
+            auto tasks = this->sub_workflow_expander->expand(this->getWorkflow(), this->workflow_index->getTask(node),
+                                                             &transformations, this->rescue_dag.get());
+
+            SubWorkflow sub_workflow;
+            sub_workflow.first = this->workflow_index->getNumberOfTasks();
+            sub_workflow.last = sub_workflow.first + tasks.size();
+            sub_workflow.pending = tasks.size();
+            this->sub_workflows[node] = sub_workflow;
+            if (tasks.empty()) {
+                this->completed_sub_workflows.push_back(node);
+                return;
+            }
+
+            unsigned long first_cluster = this->job_clustering->getNumberOfClusters();
+            this->workflow_index->append(this->getWorkflow(), tasks, node, transformations);
+            this->job_clustering->cluster(*this->workflow_index);
+
+            unsigned long num_tasks = this->workflow_index->getNumberOfTasks();
+            auto &categories = this->workflow_index->getCategories();
+            this->ready_queue.resize(num_tasks, categories.getNumberOfTypes());
+            this->throttle.setCategories(categories);
+            this->scheduled_tasks.resize(num_tasks, false);
+            this->pending_parents.resize(num_tasks);
+            this->task_sub_workflows.resize(num_tasks, node);
+            this->lifecycle_table->resize(num_tasks);
+            this->indexSubWorkflowNodes(sub_workflow.first);
+            this->pending_cluster_tasks.resize(this->job_clustering->getNumberOfClusters());
+            for (unsigned long cluster = first_cluster; cluster < this->job_clustering->getNumberOfClusters(); cluster++) {
+                this->pending_cluster_tasks[cluster] = this->job_clustering->getClusterTasks(cluster).size();
+            }
+
+            for (unsigned long id = sub_workflow.first; id < num_tasks; id++) {
+                this->pending_parents[id] = this->workflow_index->getParents(id).size();
+                if (this->pending_parents[id] == 0) {
+                    this->notifyTaskReady(id);
+                }
+            }
+        }
+
+        /**
+         * @brief Release the completed tasks of an expanded sub-workflow, and the files only it used (deleted
+         *        from the storage services holding them), then queue the sub-workflow node itself as a regular
+         *        job. Task and file objects thus remain proportional to the active sub-workflows, while the
+         *        per-task bookkeeping arrays (indexed by dense ID) keep a few words per task ever expanded.
+         *
+         * @param node: the dense ID of the sub-workflow node
+         */
+        void DAGMan::releaseSubWorkflow(unsigned long node) {
+            auto &sub_workflow = this->sub_workflows[node];
+            std::vector<WorkflowTask *> tasks;
+            for (unsigned long id = sub_workflow.first; id < sub_workflow.last; id++) {
+                tasks.push_back(this->workflow_index->getTask(id));
+                this->workflow_index->release(id);
+            }
+            auto files = this->sub_workflow_expander->release(this->getWorkflow(), this->workflow_index->getTask(node),
+                                                              tasks);
+            auto &replica_cache = ((DAGManScheduler *) this->getStandardJobScheduler())->getReplicaCache();
+            for (auto file : files) {
+                for (auto &location : replica_cache.getReplicas(file)) {
+                    try {
+                        StorageService::deleteFile(file, location);
+                    } catch (WorkflowExecutionException &e) {
+                        WRENCH_INFO("Unable to delete file %s: %s", file->getID().c_str(),
+                                    e.getCause()->toString().c_str());
+                    }
+                }
+                replica_cache.removeFile(file);
+                this->getWorkflow()->removeFile(file);
+            }
+            WRENCH_INFO("Released sub-workflow %s (%lu tasks, %lu files)",
+                        this->workflow_index->getTask(node)->getID().c_str(), tasks.size(), files.size());
+
+            this->enqueueReadyJob(this->job_clustering->getTaskCluster(node));
+        }
+
+        /**
+         * @brief Set the sub-workflow nodes of a hierarchical workflow and how to expand them (if not set, all
+         *        tasks run as regular jobs)
+         * @param sub_workflow_expander: the sub-workflow expander
+         */
+        void DAGMan::setSubWorkflowExpander(std::shared_ptr<SubWorkflowExpander> sub_workflow_expander) {
+            this->sub_workflow_expander = sub_workflow_expander;
+        }
+
+        /**
+         * @brief Set whether input files are staged in asynchronously (as pegasus-transfer), so that jobs are
+         *        submitted as soon as their input files land and transfers overlap with computations
+         *
+         * @param asynchronous: true if input files are staged in asynchronously
+         * @param max_concurrent_transfers: the maximum number of concurrent transfers (0 means unlimited)
+         */
+        void DAGMan::setAsynchronousStageIn(bool asynchronous, unsigned long max_concurrent_transfers) {
+            this->asynchronous_stage_in = asynchronous;
+            this->max_concurrent_transfers = max_concurrent_transfers;
+        }
+
+        /**
+         * @brief Set the number of slots of each HTCondor pool, used to balance jobs across pools
+         * @param pool_slots: a map of number of slots indexed by HTCondor service
+         */
+        void DAGMan::setPoolSlots(const std::map<std::shared_ptr<HTCondorComputeService>, unsigned long> &pool_slots) {
+            this->pool_slots = pool_slots;
+        }
+
+        /**
+         * @brief Set whether jobs are placed on the HTCondor pool already holding most of their input data
+         *        (instead of the least loaded pool)
+         * @param locality_aware_placement: true for data-locality-aware placement
+         */
+        void DAGMan::setLocalityAwarePlacement(bool locality_aware_placement) {
+            this->locality_aware_placement = locality_aware_placement;
+        }
+
+        /**
+         * @brief Set the rescue DAG that records completed tasks, and the file it is written to when DAGMan
+         *        exits (including on abort)
+         * @param rescue_dag: the rescue DAG (possibly holding the tasks completed in a previous run)
+         * @param rescue_filename: the rescue file path
+         */
+        void DAGMan::setRescueDAG(std::shared_ptr<RescueDAG> rescue_dag, const std::string &rescue_filename) {
+            this->rescue_dag = rescue_dag;
+            this->rescue_filename = rescue_filename;
+        }
+
+        /**
+         * @brief Set whether the power meter integrates energy exactly each time the set of running tasks of a
+         *        host changes, instead of sampling power every second
+         * @param exact_energy: true for exact energy integration
+         */
+        void DAGMan::setExactEnergy(bool exact_energy) {
+            this->exact_energy = exact_energy;
+        }
+
+        /**
+         * @brief Get the power meter of the execution hosts
+         * @return the power meter (nullptr if no energy scheme is provided)
+         */
+        std::shared_ptr<PowerMeter> DAGMan::getPowerMeter() {
+            return this->power_meter;
+        }
+
+        /**
+         * @brief Get the submission, scheduling and completion dates of the workflow tasks
+         * @return the lifecycle table (nullptr before the execution starts)
+         */
+        std::shared_ptr<TaskLifecycleTable> DAGMan::getTaskLifecycleTable() {
+            return this->lifecycle_table;
+        }
+
+        /**
+         * @brief Get the number of job events (submissions and completions) processed by DAGMan, e.g., to
+         *        measure the simulator throughput
+         * @return the number of processed job events
+         */
+        unsigned long DAGMan::getNumberOfProcessedEvents() {
+            return this->statistics->loop.submitted_jobs + this->statistics->loop.completed_jobs;
+        }
+
+        /**
+         * @brief Get the counters of the scheduling loop, scheduler, and monitor
+         * @return the DAGMan statistics (nullptr before the execution starts)
+         */
+        std::shared_ptr<DAGManStatistics> DAGMan::getStatistics() {
+            return this->statistics;
+        }
+
+        /**
+         * @brief Set the sink to which task lifecycle records are streamed as tasks complete
+         * @param trace_sink: the trace sink
+         */
+        void DAGMan::setTraceSink(std::shared_ptr<TaskTraceSink> trace_sink) {
+            this->trace_sink = trace_sink;
+        }
+
+        /**
+         * @brief Set the DAGMan throttling settings
+         * @param throttle: the throttling settings
+         */
+        void DAGMan::setThrottle(const DAGManThrottle &throttle) {
+            this->throttle = throttle;
+        }
+
+        /**
+         * @brief Get the number of submitted jobs that have not started running yet. Jobs that have started
+         *        are forgotten, so that each submitted job is checked until it starts only.
+         *
+         * @return number of idle jobs
+         */
+        unsigned long DAGMan::getNumberOfIdleJobs() {
+            for (auto cluster = this->idle_clusters.begin(); cluster != this->idle_clusters.end();) {
+                bool started = false;
+                for (auto id : this->job_clustering->getClusterTasks(*cluster)) {
+                    if (this->workflow_index->getTask(id)->getStartDate() >= 0) {
+                        started = true;
+                        break;
+                    }
+                }
+                if (started) {
+                    cluster = this->idle_clusters.erase(cluster);
+                } else {
+                    ++cluster;
+                }
+            }
+            return this->idle_clusters.size();
         }
 
         /**
-         * @brief Extract the task ID type from a task ID
+         * @brief Set the job clustering (if not set, each task runs as a separate job)
+         * @param job_clustering: the clusters of the workflow to be executed
+         */
+        void DAGMan::setJobClustering(std::shared_ptr<JobClustering> job_clustering) {
+            this->job_clustering = job_clustering;
+        }
+
+        /**
+         * @brief Set the workflow index (if not set, DAGMan builds it when starting)
+         * @param workflow_index: the index of the workflow to be executed
+         */
+        void DAGMan::setWorkflowIndex(std::shared_ptr<WorkflowIndex> workflow_index) {
+            this->workflow_index = workflow_index;
+        }
+
+        /**
+         * @brief Block until the DAGManMonitor notifies that job completions are available. A notification
+         *        whose events have already been collected (e.g., while DAGMan was sleeping between submissions)
+         *        is drained first, so that it does not wake DAGMan up with nothing to process.
+         *
+         * @param timeout: maximum time to wait in seconds (0 means no timeout)
          *
-         * @param taskID: task ID
-         * @return Task ID type
+         * @throw std::runtime_error
          */
-        std::string DAGMan::getTaskIDType(const std::string &taskID) {
-            return taskID.substr(0, taskID.find('_'));
+        void DAGMan::waitForMonitorNotification(double timeout) {
+            bool stale = this->dagman_monitor->isNotificationPending() && not this->dagman_monitor->hasEvents();
+            while (true) {
+                std::shared_ptr<SimulationMessage> message = nullptr;
+
+                if (timeout > 0 && not stale) {
+                    try {
+                        message = S4U_Mailbox::getMessage(this->mailbox_name, timeout);
+                    } catch (std::shared_ptr<NetworkError> &cause) {
+                        // no job completed during the timeout
+                        this->statistics->loop.wait_timeouts++;
+                        return;
+                    }
+                } else {
+                    message = S4U_Mailbox::getMessage(this->mailbox_name);
+                }
+
+                if (auto msg = dynamic_cast<ServiceStopDaemonMessage *>(message.get())) {
+                    this->abort = true;
+                    return;
+                } else if (not dynamic_cast<DAGManMonitorNotificationMessage *>(message.get())) {
+                    throw std::runtime_error(
+                            "DAGMan::waitForMonitorNotification(): Unexpected [" + message->getName() + "] message");
+                }
+                this->dagman_monitor->notificationReceived();
+
+                // events received while draining a stale notification were coalesced into it
+                if (not stale || this->dagman_monitor->hasEvents()) {
+                    break;
+                }
+                stale = false;
+            }
+            this->statistics->loop.notifications++;
+
+            // simulate the HTCondor user log scan window to process job completions in batches
+            if (this->coalesce_window > 0) {
+                Simulation::sleep(this->coalesce_window);
+            }
         }
 
         /**
@@ -268,7 +817,8 @@ namespace wrench {
         std::shared_ptr<PowerMeter> DAGMan::createPowerMeter(const std::vector<std::string> &hostname_list,
                                                              double measurement_period) {
             auto power_meter_raw_ptr = new PowerMeter(this, hostname_list, measurement_period,
-                                                      this->energy_scheme == "pairwise");
+                                                      this->energy_scheme == "pairwise", this->workflow_index,
+                                                      this->exact_energy);
             std::shared_ptr<PowerMeter> power_meter = std::shared_ptr<PowerMeter>(power_meter_raw_ptr);
             power_meter->simulation = this->simulation;
             power_meter->start(power_meter, true, true); // Always daemonize
@@ -289,8 +839,24 @@ namespace wrench {
 
 //            this->job_manager->forgetJob(job);
 
-            for (auto task : job->getTasks()) {
-                this->scheduled_tasks.erase(task);
+            this->processJobFailure(job->getTasks());
+        }
+
+        /**
+         * @brief Put the tasks of a failed job (which did not run, or failed) back in the ready queue, and abort
+         *        the workflow execution
+         *
+         * @param job_tasks: the tasks of the job
+         */
+        void DAGMan::processJobFailure(const std::vector<WorkflowTask *> &job_tasks) {
+            for (auto task : job_tasks) {
+                this->scheduled_tasks[this->workflow_index->getTaskIndex(task)] = false;
+            }
+            if (not job_tasks.empty()) {
+                unsigned long cluster = this->job_clustering->getTaskCluster(
+                        this->workflow_index->getTaskIndex(job_tasks.front()));
+                this->idle_clusters.erase(cluster);
+                this->enqueueReadyJob(cluster);
             }
 
             // TODO: retry tasks
@@ -12,7 +12,16 @@
 
 #include <wrench-dev.h>
 #include "DAGManMonitor.h"
+#include "DAGManReadyQueue.h"
+#include "DAGManStatistics.h"
+#include "DAGManThrottle.h"
+#include "JobClustering.h"
+#include "RescueDAG.h"
+#include "SubWorkflowExpander.h"
+#include "TaskLifecycleTable.h"
+#include "TaskTraceSink.h"
 #include "PowerMeter.h"
+#include "WorkflowIndex.h"
 
 namespace wrench {
     namespace pegasus {
@@ -30,6 +39,36 @@ namespace wrench {
 
             void setExecutionHosts(const std::vector<std::string> &execution_hosts);
 
+            void setEventDriven(bool event_driven, double coalesce_window = 0);
+
+            void setWorkflowIndex(std::shared_ptr<WorkflowIndex> workflow_index);
+
+            void setThrottle(const DAGManThrottle &throttle);
+
+            void setPoolSlots(const std::map<std::shared_ptr<HTCondorComputeService>, unsigned long> &pool_slots);
+
+            void setLocalityAwarePlacement(bool locality_aware_placement);
+
+            void setRescueDAG(std::shared_ptr<RescueDAG> rescue_dag, const std::string &rescue_filename);
+
+            void setExactEnergy(bool exact_energy);
+
+            std::shared_ptr<PowerMeter> getPowerMeter();
+
+            std::shared_ptr<TaskLifecycleTable> getTaskLifecycleTable();
+
+            unsigned long getNumberOfProcessedEvents();
+
+            std::shared_ptr<DAGManStatistics> getStatistics();
+
+            void setTraceSink(std::shared_ptr<TaskTraceSink> trace_sink);
+
+            void setAsynchronousStageIn(bool asynchronous, unsigned long max_concurrent_transfers = 0);
+
+            void setJobClustering(std::shared_ptr<JobClustering> job_clustering);
+
+            void setSubWorkflowExpander(std::shared_ptr<SubWorkflowExpander> sub_workflow_expander);
+
         protected:
             /***********************/
             /** \cond DEVELOPER    */
@@ -37,11 +76,25 @@ namespace wrench {
 
             void processEventStandardJobFailure(std::shared_ptr<StandardJobFailedEvent>) override;
 
-            std::string getTaskIDType(const std::string &taskID);
+            void processJobFailure(const std::vector<WorkflowTask *> &job_tasks);
+
+            void notifyTaskReady(unsigned long id);
+
+            void enqueueReadyJob(unsigned long cluster);
+
+            void indexSubWorkflowNodes(unsigned long first);
+
+            void expandSubWorkflow(unsigned long node);
+
+            void releaseSubWorkflow(unsigned long node);
 
             std::shared_ptr<PowerMeter> createPowerMeter(const std::vector<std::string> &hostname_list,
                                                          double measurement_period);
 
+            void waitForMonitorNotification(double timeout = 0);
+
+            unsigned long getNumberOfIdleJobs();
+
             /***********************/
             /** \endcond           */
             /***********************/
@@ -49,8 +102,31 @@ namespace wrench {
         private:
             int main() override;
 
-            struct TaskPriorityComparator {
-                bool operator()(WorkflowTask *&lhs, WorkflowTask *&rhs);
+            /**
+             * @brief Position of the DAGMan scan in the ready jobs of a task category
+             */
+            struct CategoryCursor {
+                /** @brief The task category */
+                unsigned int category;
+                /** @brief The next job to be scanned */
+                DAGManReadyQueue::EntrySet::const_iterator next;
+                /** @brief Number of category jobs not scanned yet (including the next one) */
+                unsigned long remaining;
+            };
+
+            void execute();
+
+            void writeOutputFiles();
+
+            /**
+             * @brief An expanded sub-workflow
+             */
+            struct SubWorkflow {
+                /** @brief Dense IDs of the sub-workflow tasks, from first (included) to last (excluded) */
+                unsigned long first;
+                unsigned long last;
+                /** @brief Number of sub-workflow tasks that have not completed yet */
+                unsigned long pending;
             };
 
             /** @brief The job manager */
@@ -63,16 +139,70 @@ namespace wrench {
             std::pair<unsigned long, unsigned long> running_tasks_level;
             /** @brief */
             unsigned long running_register_tasks = 0;
-            /** @brief Set of tasks scheduled for running */
-            std::set<WorkflowTask *> scheduled_tasks;
-            /** @brief Pair of current running task transformation type */
-            std::pair<std::string, int> current_running_task_type;
+            /** @brief Compact index of the workflow DAG */
+            std::shared_ptr<WorkflowIndex> workflow_index;
+            /** @brief Whether a task has been scheduled for running, indexed by dense task ID */
+            std::vector<bool> scheduled_tasks;
+            /** @brief Number of parents that have not completed yet, indexed by dense task ID */
+            std::vector<unsigned long> pending_parents;
+            /** @brief Number of completed tasks */
+            unsigned long completed_tasks = 0;
+            /** @brief Counters of the scheduling loop, scheduler, and monitor */
+            std::shared_ptr<DAGManStatistics> statistics;
+            /** @brief Clusters of the workflow tasks (i.e., jobs) */
+            std::shared_ptr<JobClustering> job_clustering;
+            /** @brief Number of tasks that are not ready yet, indexed by cluster ID */
+            std::vector<unsigned long> pending_cluster_tasks;
+            /** @brief Clusters (i.e., jobs) submitted and not known to have started yet */
+            std::set<unsigned long> idle_clusters;
+            /** @brief Expansion of sub-workflow nodes (if the workflow is hierarchical) */
+            std::shared_ptr<SubWorkflowExpander> sub_workflow_expander;
+            /** @brief Whether a task is a sub-workflow node not expanded yet, indexed by dense task ID */
+            std::vector<bool> sub_workflow_nodes;
+            /** @brief Node of the sub-workflow each task belongs to (if any), indexed by dense task ID */
+            std::vector<unsigned long> task_sub_workflows;
+            /** @brief Expanded sub-workflows, indexed by node dense ID */
+            std::map<unsigned long, SubWorkflow> sub_workflows;
+            /** @brief Sub-workflow nodes ready to be expanded */
+            std::vector<unsigned long> ready_sub_workflows;
+            /** @brief Sub-workflow nodes whose tasks have all completed, to be released */
+            std::vector<unsigned long> completed_sub_workflows;
+            /** @brief Job throttling settings and bookkeeping */
+            DAGManThrottle throttle;
+            /** @brief Priority-ordered queue of ready tasks not yet scheduled */
+            DAGManReadyQueue ready_queue;
+            /** @brief Pair of current running task type and number of running tasks of that type */
+            std::pair<unsigned int, unsigned long> current_running_task_type;
             /** @brief */
             std::shared_ptr<DAGManMonitor> dagman_monitor;
             /** @brief List of execution hosts */
             std::vector<std::string> execution_hosts;
+            /** @brief Power meter of the execution hosts (if an energy scheme is provided) */
+            std::shared_ptr<PowerMeter> power_meter;
             /** @brief Energy scheme (if provided) */
             std::string energy_scheme;
+            /** @brief Whether energy is integrated exactly upon changes instead of sampled every second */
+            bool exact_energy = false;
+            /** @brief Whether DAGMan waits for monitor notifications instead of polling */
+            bool event_driven = false;
+            /** @brief Time window for coalescing job completions after a notification (event-driven mode) */
+            double coalesce_window = 0;
+            /** @brief Number of slots of each HTCondor pool */
+            std::map<std::shared_ptr<HTCondorComputeService>, unsigned long> pool_slots;
+            /** @brief Whether jobs are placed on the pool holding most of their input data */
+            bool locality_aware_placement = false;
+            /** @brief Submission, scheduling and completion dates of the tasks */
+            std::shared_ptr<TaskLifecycleTable> lifecycle_table;
+            /** @brief Sink for task lifecycle records (if provided) */
+            std::shared_ptr<TaskTraceSink> trace_sink;
+            /** @brief Completed tasks to be written to the rescue file */
+            std::shared_ptr<RescueDAG> rescue_dag;
+            /** @brief Rescue file path (if empty, no rescue file is written) */
+            std::string rescue_filename;
+            /** @brief Whether input files are staged in asynchronously */
+            bool asynchronous_stage_in = false;
+            /** @brief Maximum number of concurrent stage-in transfers (0 means unlimited) */
+            unsigned long max_concurrent_transfers = 0;
         };
     }
 }
@@ -0,0 +1,32 @@
+/**
+ * Copyright (c) 2017-2021. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include "DAGManMessage.h"
+
+namespace wrench {
+    namespace pegasus {
+
+        /**
+         * @brief Constructor
+         *
+         * @param name: the message name
+         * @param payload: the message size in bytes
+         */
+        DAGManMessage::DAGManMessage(std::string name, double payload) :
+                SimulationMessage("DAGManMessage::" + name, payload) {}
+
+        /**
+         * @brief Constructor
+         *
+         * @param payload: the message size in bytes
+         */
+        DAGManMonitorNotificationMessage::DAGManMonitorNotificationMessage(double payload) :
+                DAGManMessage("MONITOR_NOTIFICATION", payload) {}
+    }
+}
@@ -0,0 +1,36 @@
+/**
+ * Copyright (c) 2017-2021. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef PEGASUS_DAGMANMESSAGE_H
+#define PEGASUS_DAGMANMESSAGE_H
+
+#include <wrench-dev.h>
+
+namespace wrench {
+    namespace pegasus {
+
+        /**
+         * @brief Top-level class for messages exchanged between DAGMan and its helper daemons
+         */
+        class DAGManMessage : public SimulationMessage {
+        protected:
+            DAGManMessage(std::string name, double payload);
+        };
+
+        /**
+         * @brief A message sent by the DAGManMonitor to wake up DAGMan when new job completions are available
+         */
+        class DAGManMonitorNotificationMessage : public DAGManMessage {
+        public:
+            DAGManMonitorNotificationMessage(double payload);
+        };
+    }
+}
+
+#endif //PEGASUS_DAGMANMESSAGE_H
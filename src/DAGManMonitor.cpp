@@ -8,6 +8,7 @@
  */
 
 #include "DAGManMonitor.h"
+#include "DAGManMessage.h"
 
 XBT_LOG_NEW_DEFAULT_CATEGORY(DAGManMonitor, "Log category for DAGManMonitor");
 
@@ -18,9 +19,13 @@ namespace wrench {
          * @brief Constructor
          *
          * @param hostname: the name of the host on which the service will run
+         * @param workflow: the workflow being monitored
+         * @param dagman_mailbox: the DAGMan mailbox to be notified upon job completions (if empty,
+         *                        DAGMan is expected to poll for completed jobs)
          */
-        DAGManMonitor::DAGManMonitor(std::string &hostname, Workflow *workflow) :
-                Service(hostname, "dagman_monitor", "dagman_monitor"), workflow(workflow) {}
+        DAGManMonitor::DAGManMonitor(std::string &hostname, Workflow *workflow, const std::string &dagman_mailbox) :
+                Service(hostname, "dagman_monitor", "dagman_monitor"), workflow(workflow),
+                dagman_mailbox(dagman_mailbox) {}
 
         /**
          * @brief Destructor
@@ -49,6 +54,52 @@ namespace wrench {
             return completed_jobs_set;
         }
 
+        /**
+         * @brief Get the file copy (completion or failure) events received since the last call
+         *
+         * @return a list of file copy events
+         */
+        std::vector<std::shared_ptr<WorkflowExecutionEvent>> DAGManMonitor::getFileCopyEvents() {
+            auto file_copy_events_list = this->file_copy_events;
+            this->file_copy_events.clear();
+            return file_copy_events_list;
+        }
+
+        /**
+         * @brief Get whether completed jobs or file copy events are waiting to be collected
+         *
+         * @return true if events are waiting
+         */
+        bool DAGManMonitor::hasEvents() const {
+            return not this->completed_jobs.empty() || not this->file_copy_events.empty();
+        }
+
+        /**
+         * @brief Get whether a notification has been sent to DAGMan and not yet received
+         *
+         * @return true if a notification is pending
+         */
+        bool DAGManMonitor::isNotificationPending() const {
+            return this->notification_pending;
+        }
+
+        /**
+         * @brief Acknowledge that DAGMan has received the pending notification, so that the next event sends a
+         *        new one
+         */
+        void DAGManMonitor::notificationReceived() {
+            this->notification_pending = false;
+        }
+
+        /**
+         * @brief Set the statistics in which received events and sent notifications are counted
+         *
+         * @param statistics: the DAGMan statistics
+         */
+        void DAGManMonitor::setStatistics(std::shared_ptr<DAGManStatistics> statistics) {
+            this->statistics = statistics;
+        }
+
         /**
          * @brief Main method of the DAGMan monitor daemon
          *
@@ -94,6 +145,15 @@ namespace wrench {
                 std::shared_ptr<StandardJob> job = real_event->standard_job;
                 this->processStandardJobCompletion(job);
 
+            } else if (std::dynamic_pointer_cast<FileCopyCompletedEvent>(event) ||
+                       std::dynamic_pointer_cast<FileCopyFailedEvent>(event)) {
+                // stage-in transfers are handled by the DAGMan scheduler
+                this->file_copy_events.push_back(event);
+                if (this->statistics) {
+                    this->statistics->monitor.file_copy_events++;
+                }
+                this->notifyDAGMan();
+
             } else {
                 throw std::runtime_error("Unexpected workflow execution event: " + event->toString());
             }
@@ -115,6 +175,31 @@ namespace wrench {
             }
 
             this->completed_jobs.insert(job);
+            if (this->statistics) {
+                this->statistics->monitor.job_completions++;
+            }
+            this->notifyDAGMan();
+        }
+
+        /**
+         * @brief Wake up DAGMan (if it is waiting for notifications). At most one notification is in flight
+         *        at any time, further completions are coalesced until DAGMan receives it.
+         */
+        void DAGManMonitor::notifyDAGMan() {
+            if (this->dagman_mailbox.empty()) {
+                return;
+            }
+            if (this->notification_pending) {
+                if (this->statistics) {
+                    this->statistics->monitor.coalesced_events++;
+                }
+                return;
+            }
+            this->notification_pending = true;
+            if (this->statistics) {
+                this->statistics->monitor.notifications++;
+            }
+            S4U_Mailbox::dputMessage(this->dagman_mailbox, new DAGManMonitorNotificationMessage(0));
         }
     }
 }
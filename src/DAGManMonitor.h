@@ -12,6 +12,8 @@
 
 #include <wrench-dev.h>
 
+#include "DAGManStatistics.h"
+
 namespace wrench {
     namespace pegasus {
 
@@ -20,7 +22,7 @@ namespace wrench {
          */
         class DAGManMonitor : public Service {
         public:
-            DAGManMonitor(std::string &hostname, Workflow *workflow);
+            DAGManMonitor(std::string &hostname, Workflow *workflow, const std::string &dagman_mailbox = "");
 
             ~DAGManMonitor() override;
 
@@ -28,6 +30,16 @@ namespace wrench {
 
             std::set<std::shared_ptr<StandardJob>> getCompletedJobs();
 
+            std::vector<std::shared_ptr<WorkflowExecutionEvent>> getFileCopyEvents();
+
+            bool hasEvents() const;
+
+            bool isNotificationPending() const;
+
+            void notificationReceived();
+
+            void setStatistics(std::shared_ptr<DAGManStatistics> statistics);
+
         private:
             int main() override;
 
@@ -35,9 +47,21 @@ namespace wrench {
 
             void processStandardJobCompletion(std::shared_ptr<StandardJob> job);
 
+            void notifyDAGMan();
+
             std::set<std::shared_ptr<StandardJob>> completed_jobs;
 
+            /** @brief Completed or failed stage-in transfers, in order of occurrence */
+            std::vector<std::shared_ptr<WorkflowExecutionEvent>> file_copy_events;
+
             Workflow *workflow;
+
+            /** @brief DAGMan mailbox to wake up on completions (empty when DAGMan polls) */
+            std::string dagman_mailbox;
+            /** @brief Whether a notification has been sent and not yet received by DAGMan */
+            bool notification_pending = false;
+            /** @brief Counters of the events received and notifications sent */
+            std::shared_ptr<DAGManStatistics> statistics;
         };
     }
 }
@@ -0,0 +1,176 @@
+/**
+ * Copyright (c) 2017-2021. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <stdexcept>
+
+#include "DAGManReadyQueue.h"
+
+namespace wrench {
+    namespace pegasus {
+
+        /**
+         * @brief Compare two queue entries: higher priority first, ties broken by dense ID (i.e., task ID order)
+         *
+         * @param lhs: a queue entry
+         * @param rhs: a queue entry
+         *
+         * @return whether the left-hand-side entry should be submitted first
+         */
+        bool DAGManReadyQueue::EntryComparator::operator()(const Entry &lhs, const Entry &rhs) const {
+            if (lhs.priority != rhs.priority) {
+                return lhs.priority > rhs.priority;
+            }
+            return lhs.id < rhs.id;
+        }
+
+        /**
+         * @brief Clear the queue and size it for a number of tasks and task types
+         *
+         * @param num_tasks: number of tasks in the workflow
+         * @param num_types: number of task types in the workflow
+         */
+        void DAGManReadyQueue::reset(unsigned long num_tasks, unsigned int num_types) {
+            this->tasks.clear();
+            this->tasks_per_type.assign(num_types, EntrySet());
+            this->tasks_per_type_category.assign(num_types, CategoryEntrySets());
+            this->queued.assign(num_tasks, false);
+            this->priorities.assign(num_tasks, 0);
+            this->types.assign(num_tasks, 0);
+            this->categories.assign(num_tasks, 0);
+        }
+
+        /**
+         * @brief Grow the queue for a larger number of tasks and task types (e.g., when a sub-workflow is
+         *        expanded), keeping queued tasks
+         *
+         * @param num_tasks: number of tasks in the workflow
+         * @param num_types: number of task types in the workflow
+         */
+        void DAGManReadyQueue::resize(unsigned long num_tasks, unsigned int num_types) {
+            this->tasks_per_type.resize(num_types);
+            this->tasks_per_type_category.resize(num_types);
+            this->queued.resize(num_tasks, false);
+            this->priorities.resize(num_tasks, 0);
+            this->types.resize(num_tasks, 0);
+            this->categories.resize(num_tasks, 0);
+        }
+
+        /**
+         * @brief Add a ready task to the queue (no-op if the task is already queued)
+         *
+         * @param id: the task dense ID
+         * @param priority: the task priority
+         * @param type: the task type
+         * @param category: the task category
+         */
+        void DAGManReadyQueue::push(unsigned long id, long priority, unsigned int type, unsigned int category) {
+            if (this->queued[id]) {
+                return;
+            }
+            Entry entry = {priority, id};
+            this->tasks.insert(entry);
+            this->tasks_per_type[type].insert(entry);
+            this->tasks_per_type_category[type][category].insert(entry);
+            this->queued[id] = true;
+            this->priorities[id] = priority;
+            this->types[id] = type;
+            this->categories[id] = category;
+        }
+
+        /**
+         * @brief Remove a task from the queue (no-op if the task is not queued)
+         *
+         * @param id: the task dense ID
+         */
+        void DAGManReadyQueue::remove(unsigned long id) {
+            if (not this->queued[id]) {
+                return;
+            }
+            Entry entry = {this->priorities[id], id};
+            this->tasks.erase(entry);
+            this->tasks_per_type[this->types[id]].erase(entry);
+            this->tasks_per_type_category[this->types[id]][this->categories[id]].erase(entry);
+            this->queued[id] = false;
+        }
+
+        /**
+         * @brief Check whether a task is queued
+         *
+         * @param id: the task dense ID
+         * @return true if the task is in the queue
+         */
+        bool DAGManReadyQueue::contains(unsigned long id) const {
+            return this->queued[id];
+        }
+
+        /**
+         * @brief Check whether the queue is empty
+         * @return true if there are no queued tasks
+         */
+        bool DAGManReadyQueue::empty() const {
+            return this->tasks.empty();
+        }
+
+        /**
+         * @brief Get the number of queued tasks
+         * @return number of queued tasks
+         */
+        unsigned long DAGManReadyQueue::size() const {
+            return this->tasks.size();
+        }
+
+        /**
+         * @brief Get the highest priority task
+         * @return the dense ID of the highest priority task
+         *
+         * @throw std::runtime_error
+         */
+        unsigned long DAGManReadyQueue::top() const {
+            if (this->tasks.empty()) {
+                throw std::runtime_error("DAGManReadyQueue::top(): the queue is empty");
+            }
+            return this->tasks.begin()->id;
+        }
+
+        /**
+         * @brief Get the type of a queued task
+         *
+         * @param id: the task dense ID
+         * @return the task type
+         *
+         * @throw std::invalid_argument
+         */
+        unsigned int DAGManReadyQueue::getType(unsigned long id) const {
+            if (not this->queued[id]) {
+                throw std::invalid_argument("DAGManReadyQueue::getType(): task is not queued");
+            }
+            return this->types[id];
+        }
+
+        /**
+         * @brief Get the queued tasks of a given type, ordered by priority
+         *
+         * @param type: the task type
+         * @return an ordered set of queue entries
+         */
+        const DAGManReadyQueue::EntrySet &DAGManReadyQueue::getTasks(unsigned int type) const {
+            return this->tasks_per_type[type];
+        }
+
+        /**
+         * @brief Get the queued tasks of a given type, ordered by priority within each category
+         *
+         * @param type: the task type
+         * @return ordered sets of queue entries (possibly empty), indexed by task category
+         */
+        const DAGManReadyQueue::CategoryEntrySets &DAGManReadyQueue::getTasksPerCategory(unsigned int type) const {
+            return this->tasks_per_type_category[type];
+        }
+    }
+}
@@ -0,0 +1,81 @@
+/**
+ * Copyright (c) 2017-2021. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef PEGASUS_DAGMANREADYQUEUE_H
+#define PEGASUS_DAGMANREADYQUEUE_H
+
+#include <map>
+#include <set>
+#include <vector>
+
+namespace wrench {
+    namespace pegasus {
+
+        /**
+         * @brief A priority-ordered queue of ready tasks, indexed by task type and category, which is
+         *        maintained incrementally as tasks become ready and are submitted. Tasks are identified by
+         *        their dense IDs in the WorkflowIndex.
+         */
+        class DAGManReadyQueue {
+        public:
+            struct Entry {
+                long priority;
+                unsigned long id;
+            };
+
+            struct EntryComparator {
+                bool operator()(const Entry &lhs, const Entry &rhs) const;
+            };
+
+            typedef std::set<Entry, EntryComparator> EntrySet;
+
+            typedef std::map<unsigned int, EntrySet> CategoryEntrySets;
+
+            void reset(unsigned long num_tasks, unsigned int num_types);
+
+            void resize(unsigned long num_tasks, unsigned int num_types);
+
+            void push(unsigned long id, long priority, unsigned int type, unsigned int category);
+
+            void remove(unsigned long id);
+
+            bool contains(unsigned long id) const;
+
+            bool empty() const;
+
+            unsigned long size() const;
+
+            unsigned long top() const;
+
+            unsigned int getType(unsigned long id) const;
+
+            const EntrySet &getTasks(unsigned int type) const;
+
+            const CategoryEntrySets &getTasksPerCategory(unsigned int type) const;
+
+        private:
+            /** @brief All ready tasks ordered by priority */
+            EntrySet tasks;
+            /** @brief Ready tasks ordered by priority, indexed by task type */
+            std::vector<EntrySet> tasks_per_type;
+            /** @brief Ready tasks ordered by priority, indexed by task type and category */
+            std::vector<CategoryEntrySets> tasks_per_type_category;
+            /** @brief Whether a task is queued, indexed by dense ID */
+            std::vector<bool> queued;
+            /** @brief Priority of each queued task, indexed by dense ID */
+            std::vector<long> priorities;
+            /** @brief Type of each queued task, indexed by dense ID */
+            std::vector<unsigned int> types;
+            /** @brief Category of each queued task, indexed by dense ID */
+            std::vector<unsigned int> categories;
+        };
+    }
+}
+
+#endif //PEGASUS_DAGMANREADYQUEUE_H
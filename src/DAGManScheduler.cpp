@@ -8,7 +8,6 @@
  */
 
 #include "DAGManScheduler.h"
-#include "PegasusSimulationTimestampTypes.h"
 
 XBT_LOG_NEW_DEFAULT_CATEGORY(HTCondorSchedd, "Log category for HTCondor Scheduler Daemon");
 
@@ -23,7 +22,8 @@ namespace wrench {
          */
         DAGManScheduler::DAGManScheduler(std::shared_ptr<FileRegistryService> &file_registry_service,
                                          const std::set<std::shared_ptr<StorageService>> &storage_services)
-                : file_registry_service(file_registry_service), storage_services(storage_services) {}
+                : file_registry_service(file_registry_service), storage_services(storage_services),
+                  replica_cache(file_registry_service) {}
 
         /**
          * @brief Destructor
@@ -42,54 +42,447 @@ namespace wrench {
                                             const std::vector<WorkflowTask *> &tasks) {
 
             WRENCH_INFO("There are %ld ready tasks to schedule", tasks.size());
+            auto &statistics = this->statistics->scheduler;
+            auto start = DAGManStatistics::now();
+            statistics.calls++;
 
-            // TODO: select htcondor service based on condor queue name
-            auto htcondor_service = std::dynamic_pointer_cast<HTCondorComputeService>(*compute_services.begin());
+            std::vector<std::shared_ptr<HTCondorComputeService>> htcondor_services;
+            for (auto &compute_service : compute_services) {
+                if (auto htcondor_service = std::dynamic_pointer_cast<HTCondorComputeService>(compute_service)) {
+                    htcondor_services.push_back(htcondor_service);
+                }
+            }
+            if (htcondor_services.empty()) {
+                throw std::runtime_error("DAGManScheduler::scheduleTasks(): No HTCondor service available");
+            }
 
-            unsigned long scheduled_tasks = 0;
+            unsigned long scheduled_jobs = 0;
 
-            for (auto task : tasks) {
-                std::shared_ptr<StandardJob> job = nullptr;
+            // tasks of the same cluster are consecutive and run as a single job
+            auto it = tasks.begin();
+            while (it != tasks.end()) {
+                auto job_end = it + 1;
+                if (this->job_clustering) {
+                    unsigned long cluster = this->job_clustering->getTaskCluster(
+                            this->workflow_index->getTaskIndex(*it));
+                    while (job_end != tasks.end() &&
+                           this->job_clustering->getTaskCluster(this->workflow_index->getTaskIndex(*job_end)) ==
+                           cluster) {
+                        job_end++;
+                    }
+                }
+                std::vector<WorkflowTask *> job_tasks(it, job_end);
+                it = job_end;
+
+                // outputs of tasks in the job are produced locally
+                std::set<WorkflowFile *> job_output_files;
+                for (auto task : job_tasks) {
+                    for (auto file : task->getOutputFiles()) {
+                        job_output_files.insert(file);
+                    }
+                }
+                std::set<WorkflowFile *> job_input_files;
+                for (auto task : job_tasks) {
+                    for (auto file : task->getInputFiles()) {
+                        if (job_output_files.find(file) == job_output_files.end()) {
+                            job_input_files.insert(file);
+                        }
+                    }
+                }
+
+                // the job is dispatched to a pool as soon as it is ready, its input files are then staged in to
+                // the local storage service of the pool
+                auto htcondor_service = this->locality_aware_placement
+                                        ? this->selectPoolByLocality(htcondor_services, job_input_files)
+                                        : this->selectPool(htcondor_services);
+                auto local_storage_service = htcondor_service->getLocalStorageService();
+                this->pool_jobs[htcondor_service.get()]++;
 
                 // check whether files need to be staged in
-                for (auto file : task->getInputFiles()) {
-                    if (not htcondor_service->getLocalStorageService()->lookupFile(
-                            file, FileLocation::LOCATION(htcondor_service->getLocalStorageService(), "/"))) {
-
-                        auto file_locations = this->file_registry_service->lookupEntry(file);
-                        this->getDataMovementManager()->doSynchronousFileCopy(
-                                file, *file_locations.begin(),
-                                FileLocation::LOCATION(htcondor_service->getLocalStorageService(), "/"));
+                std::set<WorkflowFile *> missing_files;
+                for (auto file : job_input_files) {
+                    if (not this->replica_cache.isResident(file, local_storage_service)) {
+                        missing_files.insert(file);
+                    }
+                }
+
+                if (not this->asynchronous_stage_in) {
+                    double stage_in_start = S4U_Simulation::getClock();
+                    for (auto file : missing_files) {
+                        auto src = this->replica_selector.selectReplica(file, this->replica_cache.getReplicas(file),
+                                                                        local_storage_service);
+                        auto dst = FileLocation::LOCATION(local_storage_service, "/");
+                        this->getDataMovementManager()->doSynchronousFileCopy(file, src, dst);
+                        this->replica_cache.addReplica(file, dst);
+                        statistics.synchronous_transfers++;
+                    }
+                    statistics.stage_in_simulated_time += S4U_Simulation::getClock() - stage_in_start;
+                    missing_files.clear();
+                }
+
+                if (missing_files.empty()) {
+                    this->submitJob(job_tasks, htcondor_service);
+                    scheduled_jobs++;
+                    statistics.immediate_jobs++;
+                    continue;
+                }
+
+                // the job is submitted once all its missing input files have been staged in
+                unsigned long staging_job_id = this->next_staging_job_id++;
+                StagingJob staging_job;
+                staging_job.tasks = job_tasks;
+                staging_job.htcondor_service = htcondor_service;
+                staging_job.missing_files = missing_files.size();
+                this->staging_jobs[staging_job_id] = staging_job;
+                statistics.staging_jobs++;
+
+                for (auto file : missing_files) {
+                    auto transfer_key = std::make_pair(file, local_storage_service.get());
+                    auto waiting_jobs = this->transfer_waiting_jobs.find(transfer_key);
+                    if (waiting_jobs == this->transfer_waiting_jobs.end()) {
+                        // no transfer of the file to this storage service is queued or running yet
+                        Transfer transfer;
+                        transfer.file = file;
+                        transfer.dst = FileLocation::LOCATION(local_storage_service, "/");
+                        this->queued_transfers.push_back(transfer);
+                        this->transfer_waiting_jobs[transfer_key].push_back(staging_job_id);
+                    } else {
+                        waiting_jobs->second.push_back(staging_job_id);
                     }
                 }
+            }
+
+            this->startTransfers();
+            statistics.wall_time += DAGManStatistics::elapsed(start);
+
+            WRENCH_INFO("Done with scheduling tasks as standard jobs: %ld jobs submitted, %ld jobs waiting for stage-in",
+                        scheduled_jobs, this->staging_jobs.size());
+        }
+
+        /**
+         * @brief Process the completion of an asynchronous stage-in transfer, and submit jobs for which all
+         *        input files have been staged in
+         *
+         * @param file: the transferred file
+         * @param src: the location the file was transferred from
+         * @param dst: the location the file was transferred to
+         */
+        void DAGManScheduler::processFileCopyCompletion(WorkflowFile *file, const std::shared_ptr<FileLocation> &src,
+                                                        const std::shared_ptr<FileLocation> &dst) {
+            auto transfer_key = std::make_pair(file, dst->getStorageService().get());
+            auto waiting_jobs = this->transfer_waiting_jobs.find(transfer_key);
+            if (waiting_jobs == this->transfer_waiting_jobs.end()) {
+                throw std::runtime_error(
+                        "DAGManScheduler::processFileCopyCompletion(): Unexpected transfer of file " + file->getID());
+            }
+            WRENCH_INFO("File %s has been staged in", file->getID().c_str());
+            this->replica_cache.addReplica(file, dst);
+            std::vector<unsigned long> staging_job_ids = waiting_jobs->second;
+            this->transfer_waiting_jobs.erase(waiting_jobs);
+            this->replica_selector.notifyTransferCompleted(src);
+            this->running_transfers--;
+
+            for (auto staging_job_id : staging_job_ids) {
+                auto staging_job = this->staging_jobs.find(staging_job_id);
+                if (staging_job == this->staging_jobs.end()) {
+                    // the job has failed because another of its input files could not be staged in
+                    continue;
+                }
+                if (--staging_job->second.missing_files == 0) {
+                    this->submitJob(staging_job->second.tasks, staging_job->second.htcondor_service);
+                    this->staging_jobs.erase(staging_job);
+                }
+            }
+
+            this->startTransfers();
+        }
+
+        /**
+         * @brief Process the failure of an asynchronous stage-in transfer: the jobs waiting for the file fail,
+         *        and are not submitted
+         *
+         * @param file: the file that could not be transferred
+         * @param src: the location the file was transferred from
+         * @param dst: the location the file was transferred to
+         * @param failure_cause: the cause of the failure
+         * @return the tasks of each failed job
+         *
+         * @throw std::runtime_error
+         */
+        std::vector<std::vector<WorkflowTask *>>
+        DAGManScheduler::processFileCopyFailure(WorkflowFile *file, const std::shared_ptr<FileLocation> &src,
+                                                const std::shared_ptr<FileLocation> &dst,
+                                                const std::shared_ptr<FailureCause> &failure_cause) {
+            auto transfer_key = std::make_pair(file, dst->getStorageService().get());
+            auto waiting_jobs = this->transfer_waiting_jobs.find(transfer_key);
+            if (waiting_jobs == this->transfer_waiting_jobs.end()) {
+                throw std::runtime_error(
+                        "DAGManScheduler::processFileCopyFailure(): Unexpected transfer of file " + file->getID());
+            }
+            WRENCH_INFO("Unable to stage in file %s: %s", file->getID().c_str(), failure_cause->toString().c_str());
+            std::vector<unsigned long> staging_job_ids = waiting_jobs->second;
+            this->transfer_waiting_jobs.erase(waiting_jobs);
+            this->replica_selector.notifyTransferCompleted(src);
+            this->running_transfers--;
+
+            std::vector<std::vector<WorkflowTask *>> failed_jobs;
+            for (auto staging_job_id : staging_job_ids) {
+                auto staging_job = this->staging_jobs.find(staging_job_id);
+                if (staging_job == this->staging_jobs.end()) {
+                    // the job has already failed because of another of its input files
+                    continue;
+                }
+                // the job releases the pool it was dispatched to
+                this->pool_jobs[staging_job->second.htcondor_service.get()]--;
+                failed_jobs.push_back(staging_job->second.tasks);
+                this->staging_jobs.erase(staging_job);
+            }
+
+            this->startTransfers();
+            return failed_jobs;
+        }
+
+        /**
+         * @brief Initiate queued stage-in transfers, up to the maximum number of concurrent transfers
+         */
+        void DAGManScheduler::startTransfers() {
+            while (not this->queued_transfers.empty() &&
+                   (this->max_concurrent_transfers == 0 ||
+                    this->running_transfers < this->max_concurrent_transfers)) {
+                auto transfer = this->queued_transfers.front();
+                this->queued_transfers.pop_front();
+
+                // the source is selected when the transfer starts, based on the transfers in flight
+                auto src = this->replica_selector.selectReplica(transfer.file,
+                                                                this->replica_cache.getReplicas(transfer.file),
+                                                                transfer.dst->getStorageService());
+                WRENCH_INFO("Initiating stage-in of file %s from %s", transfer.file->getID().c_str(),
+                            src->toString().c_str());
+                this->getDataMovementManager()->initiateAsynchronousFileCopy(transfer.file, src, transfer.dst);
+                this->replica_selector.notifyTransferStarted(src);
+                this->running_transfers++;
+                this->statistics->scheduler.asynchronous_transfers++;
+            }
+        }
 
-                // create job start event
-                this->simulation->getOutput().addTimestamp<SimulationTimestampJobSubmitted>(
-                        new SimulationTimestampJobSubmitted(task));
+        /**
+         * @brief Create and submit a standard job for a set of tasks whose input files are available on the
+         *        local storage service of the HTCondor service
+         *
+         * @param job_tasks: the tasks of the job
+         * @param htcondor_service: the HTCondor service the job is submitted to
+         */
+        void DAGManScheduler::submitJob(const std::vector<WorkflowTask *> &job_tasks,
+                                        const std::shared_ptr<HTCondorComputeService> &htcondor_service) {
+            auto local_storage_service = htcondor_service->getLocalStorageService();
 
-                // finding the file locations
-                std::map<WorkflowFile *, std::shared_ptr<FileLocation>> file_locations;
+            // finding the file locations
+            std::map<WorkflowFile *, std::shared_ptr<FileLocation>> file_locations;
+            for (auto task : job_tasks) {
                 for (auto f : task->getInputFiles()) {
-                    file_locations[f] = FileLocation::LOCATION(htcondor_service->getLocalStorageService());
+                    file_locations[f] = FileLocation::LOCATION(local_storage_service);
                 }
                 for (auto f : task->getOutputFiles()) {
-                    file_locations[f] = FileLocation::LOCATION(htcondor_service->getLocalStorageService());
+                    file_locations[f] = FileLocation::LOCATION(local_storage_service);
                 }
+            }
 
-                // creating job for execution
-                job = this->getJobManager()->createStandardJob(task, file_locations);
+            // creating job for execution
+            auto job = this->getJobManager()->createStandardJob(job_tasks, file_locations);
 
-                WRENCH_INFO("Scheduling task: %s", task->getID().c_str());
-                this->getJobManager()->submitJob(job, htcondor_service);
-                // create job scheduled event
-                this->simulation->getOutput().addTimestamp<SimulationTimestampJobScheduled>(
-                        new SimulationTimestampJobScheduled(task));WRENCH_INFO("Scheduled task: %s",
-                                                                               task->getID().c_str());
-                scheduled_tasks++;
+            WRENCH_INFO("Scheduling job with %ld task(s), starting with task: %s", job_tasks.size(),
+                        job_tasks.front()->getID().c_str());
+            this->getJobManager()->submitJob(job, htcondor_service);
+            this->running_jobs[job] = htcondor_service;
+            for (auto task : job_tasks) {
+                this->lifecycle_table->recordScheduled(this->workflow_index->getTaskIndex(task));
+                WRENCH_INFO("Scheduled task: %s", task->getID().c_str());
             }
+        }
 
-            WRENCH_INFO("Done with scheduling tasks as standard jobs: %ld tasks scheduled out of %ld", scheduled_tasks,
-                        tasks.size());
+        /**
+         * @brief Process the completion of a job: its output files are now resident on the local storage
+         *        service of the HTCondor pool it ran on, and a slot of the pool is released
+         *
+         * @param job: the completed job
+         * @return the storage service holding the job output files (nullptr if the job is unknown)
+         */
+        std::shared_ptr<StorageService>
+        DAGManScheduler::processJobCompletion(const std::shared_ptr<StandardJob> &job) {
+            auto it = this->running_jobs.find(job);
+            if (it == this->running_jobs.end()) {
+                return nullptr;
+            }
+            auto local_storage_service = it->second->getLocalStorageService();
+            for (auto task : job->getTasks()) {
+                for (auto file : task->getOutputFiles()) {
+                    this->replica_cache.addReplica(file, FileLocation::LOCATION(local_storage_service, "/"));
+                }
+            }
+            this->pool_jobs[it->second.get()]--;
+            this->running_jobs.erase(it);
+            return local_storage_service;
+        }
+
+        /**
+         * @brief Select the HTCondor pool a job is dispatched to: the pool with the most idle slots or, if all
+         *        slots are busy, the pool with the shortest queue relative to its number of slots. Jobs
+         *        dispatched to a pool and not completed (including jobs waiting for stage-in) occupy a slot.
+         *
+         * @param htcondor_services: the HTCondor services (pools) available to run jobs
+         * @return the selected HTCondor service
+         */
+        std::shared_ptr<HTCondorComputeService>
+        DAGManScheduler::selectPool(const std::vector<std::shared_ptr<HTCondorComputeService>> &htcondor_services) {
+            if (htcondor_services.size() == 1) {
+                return htcondor_services.front();
+            }
+
+            std::shared_ptr<HTCondorComputeService> selected_pool = nullptr;
+            unsigned long best_idle_slots = 0;
+            double best_queue_depth = 0;
+            for (auto &htcondor_service : htcondor_services) {
+                unsigned long slots = this->getSlots(htcondor_service);
+                unsigned long jobs = this->pool_jobs[htcondor_service.get()];
+                unsigned long idle_slots = jobs < slots ? slots - jobs : 0;
+                double queue_depth = jobs < slots ? 0 : (double) (jobs - slots) / slots;
+
+                if (selected_pool == nullptr || idle_slots > best_idle_slots ||
+                    (best_idle_slots == 0 && idle_slots == 0 && queue_depth < best_queue_depth)) {
+                    selected_pool = htcondor_service;
+                    best_idle_slots = idle_slots;
+                    best_queue_depth = queue_depth;
+                }
+            }
+            return selected_pool;
+        }
+
+        /**
+         * @brief Select the HTCondor pool a job is dispatched to based on data locality: among the pools with idle
+         *        slots (or all pools if none has idle slots), the pool whose local storage service already holds
+         *        the most bytes of the job input files. Ties are broken by load, as in selectPool().
+         *
+         * @param htcondor_services: the HTCondor services (pools) available to run jobs
+         * @param job_input_files: the input files of the job (not produced by the job itself)
+         * @return the selected HTCondor service
+         */
+        std::shared_ptr<HTCondorComputeService> DAGManScheduler::selectPoolByLocality(
+                const std::vector<std::shared_ptr<HTCondorComputeService>> &htcondor_services,
+                const std::set<WorkflowFile *> &job_input_files) {
+            if (htcondor_services.size() == 1) {
+                return htcondor_services.front();
+            }
+
+            std::vector<std::shared_ptr<HTCondorComputeService>> candidates;
+            for (auto &htcondor_service : htcondor_services) {
+                if (this->getIdleSlots(htcondor_service) > 0) {
+                    candidates.push_back(htcondor_service);
+                }
+            }
+            if (candidates.empty()) {
+                candidates = htcondor_services;
+            }
+
+            std::vector<std::shared_ptr<HTCondorComputeService>> best_candidates;
+            double best_resident_bytes = -1;
+            for (auto &htcondor_service : candidates) {
+                double resident_bytes = 0;
+                for (auto file : job_input_files) {
+                    if (this->replica_cache.isResident(file, htcondor_service->getLocalStorageService())) {
+                        resident_bytes += file->getSize();
+                    }
+                }
+                if (resident_bytes > best_resident_bytes) {
+                    best_candidates.clear();
+                    best_resident_bytes = resident_bytes;
+                }
+                if (resident_bytes == best_resident_bytes) {
+                    best_candidates.push_back(htcondor_service);
+                }
+            }
+            return this->selectPool(best_candidates);
+        }
+
+        /**
+         * @brief Get the number of idle slots of a HTCondor pool
+         *
+         * @param htcondor_service: the HTCondor service (pool)
+         * @return the number of slots not occupied by jobs dispatched to the pool
+         */
+        unsigned long DAGManScheduler::getIdleSlots(const std::shared_ptr<HTCondorComputeService> &htcondor_service) {
+            unsigned long slots = this->getSlots(htcondor_service);
+            unsigned long jobs = this->pool_jobs[htcondor_service.get()];
+            return jobs < slots ? slots - jobs : 0;
+        }
+
+        /**
+         * @brief Get the number of slots of a HTCondor pool (pools with an unknown number of slots are assumed
+         *        to have a single slot)
+         *
+         * @param htcondor_service: the HTCondor service (pool)
+         * @return the number of slots of the pool
+         */
+        unsigned long DAGManScheduler::getSlots(const std::shared_ptr<HTCondorComputeService> &htcondor_service) {
+            auto it = this->pool_slots.find(htcondor_service);
+            return it == this->pool_slots.end() || it->second == 0 ? 1 : it->second;
+        }
+
+        /**
+         * @brief Set the table in which task scheduling dates are recorded
+         *
+         * @param lifecycle_table: the lifecycle table
+         */
+        void DAGManScheduler::setTaskLifecycleTable(std::shared_ptr<TaskLifecycleTable> lifecycle_table) {
+            this->lifecycle_table = lifecycle_table;
+        }
+
+        /**
+         * @brief Set the statistics in which scheduled jobs and stage-in transfers are counted
+         *
+         * @param statistics: the DAGMan statistics
+         */
+        void DAGManScheduler::setStatistics(std::shared_ptr<DAGManStatistics> statistics) {
+            this->statistics = statistics;
+        }
+
+        /**
+         * @brief Set whether jobs are placed on the HTCondor pool holding most of their input data
+         *
+         * @param locality_aware_placement: true for data-locality-aware placement, false for load balancing
+         */
+        void DAGManScheduler::setLocalityAwarePlacement(bool locality_aware_placement) {
+            this->locality_aware_placement = locality_aware_placement;
+        }
+
+        /**
+         * @brief Set the number of slots of each HTCondor pool, used to balance jobs across pools
+         *
+         * @param pool_slots: a map of number of slots indexed by HTCondor service
+         */
+        void DAGManScheduler::setPoolSlots(const std::map<std::shared_ptr<HTCondorComputeService>,
+                unsigned long> &pool_slots) {
+            this->pool_slots = pool_slots;
+        }
+
+        /**
+         * @brief Get the cache of replica locations used for stage-in decisions
+         *
+         * @return the replica cache
+         */
+        ReplicaCache &DAGManScheduler::getReplicaCache() {
+            return this->replica_cache;
+        }
+
+        /**
+         * @brief Set whether input files are staged in asynchronously. If so, jobs are submitted as soon as
+         *        their input files have been staged in, and transfers overlap with computations.
+         *
+         * @param asynchronous: true if input files are staged in asynchronously
+         * @param max_concurrent_transfers: the maximum number of concurrent transfers (0 means unlimited)
+         */
+        void DAGManScheduler::setAsynchronousStageIn(bool asynchronous, unsigned long max_concurrent_transfers) {
+            this->asynchronous_stage_in = asynchronous;
+            this->max_concurrent_transfers = max_concurrent_transfers;
         }
 
         /**
@@ -101,6 +494,18 @@ namespace wrench {
             this->simulation = simulation;
         }
 
+        /**
+         * @brief Set the job clustering, so that tasks of a cluster are submitted as a single job
+         *
+         * @param workflow_index: the index of the workflow being executed
+         * @param job_clustering: the clusters of the workflow tasks
+         */
+        void DAGManScheduler::setJobClustering(std::shared_ptr<WorkflowIndex> workflow_index,
+                                               std::shared_ptr<JobClustering> job_clustering) {
+            this->workflow_index = workflow_index;
+            this->job_clustering = job_clustering;
+        }
+
         /**
          * @brief:
          *
@@ -10,9 +10,17 @@
 #ifndef WRENCH_PEGASUS_SCHEDD_H
 #define WRENCH_PEGASUS_SCHEDD_H
 
+#include <deque>
 #include <vector>
 #include <wrench-dev.h>
 
+#include "DAGManStatistics.h"
+#include "JobClustering.h"
+#include "ReplicaCache.h"
+#include "ReplicaSelector.h"
+#include "TaskLifecycleTable.h"
+#include "WorkflowIndex.h"
+
 namespace wrench {
 
     class Simulation;
@@ -41,11 +49,74 @@ namespace wrench {
 
             void setMonitorCallbackMailbox(std::string monitor_callback_mailbox);
 
+            void setJobClustering(std::shared_ptr<WorkflowIndex> workflow_index,
+                                  std::shared_ptr<JobClustering> job_clustering);
+
+            void setAsynchronousStageIn(bool asynchronous, unsigned long max_concurrent_transfers);
+
+            void processFileCopyCompletion(WorkflowFile *file, const std::shared_ptr<FileLocation> &src,
+                                           const std::shared_ptr<FileLocation> &dst);
+
+            std::vector<std::vector<WorkflowTask *>>
+            processFileCopyFailure(WorkflowFile *file, const std::shared_ptr<FileLocation> &src,
+                                   const std::shared_ptr<FileLocation> &dst,
+                                   const std::shared_ptr<FailureCause> &failure_cause);
+
+            std::shared_ptr<StorageService> processJobCompletion(const std::shared_ptr<StandardJob> &job);
+
+            ReplicaCache &getReplicaCache();
+
+            void setPoolSlots(const std::map<std::shared_ptr<HTCondorComputeService>, unsigned long> &pool_slots);
+
+            void setLocalityAwarePlacement(bool locality_aware_placement);
+
+            void setTaskLifecycleTable(std::shared_ptr<TaskLifecycleTable> lifecycle_table);
+
+            void setStatistics(std::shared_ptr<DAGManStatistics> statistics);
+
             /***********************/
             /** \endcond           */
             /***********************/
 
         protected:
+            /**
+             * @brief A job waiting for its input files to be staged in
+             */
+            struct StagingJob {
+                /** @brief The tasks of the job */
+                std::vector<WorkflowTask *> tasks;
+                /** @brief The HTCondor service the job is submitted to */
+                std::shared_ptr<HTCondorComputeService> htcondor_service;
+                /** @brief Number of input files not staged in yet */
+                unsigned long missing_files;
+            };
+
+            /**
+             * @brief A stage-in transfer
+             */
+            struct Transfer {
+                /** @brief The file to be transferred */
+                WorkflowFile *file;
+                /** @brief The destination location */
+                std::shared_ptr<FileLocation> dst;
+            };
+
+            void startTransfers();
+
+            std::shared_ptr<HTCondorComputeService>
+            selectPool(const std::vector<std::shared_ptr<HTCondorComputeService>> &htcondor_services);
+
+            std::shared_ptr<HTCondorComputeService>
+            selectPoolByLocality(const std::vector<std::shared_ptr<HTCondorComputeService>> &htcondor_services,
+                                 const std::set<WorkflowFile *> &job_input_files);
+
+            unsigned long getIdleSlots(const std::shared_ptr<HTCondorComputeService> &htcondor_service);
+
+            unsigned long getSlots(const std::shared_ptr<HTCondorComputeService> &htcondor_service);
+
+            void submitJob(const std::vector<WorkflowTask *> &job_tasks,
+                           const std::shared_ptr<HTCondorComputeService> &htcondor_service);
+
             /** @brief The file registry service */
             std::shared_ptr<FileRegistryService> file_registry_service;
             /** @brief */
@@ -54,6 +125,40 @@ namespace wrench {
             Simulation *simulation;
             /** @brief */
             std::string monitor_callback_mailbox;
+            /** @brief The index of the workflow being executed */
+            std::shared_ptr<WorkflowIndex> workflow_index;
+            /** @brief Clusters of the workflow tasks */
+            std::shared_ptr<JobClustering> job_clustering;
+            /** @brief Cache of replica locations and residency on local storage services */
+            ReplicaCache replica_cache;
+            /** @brief Selection of the replica each file is staged in from */
+            ReplicaSelector replica_selector;
+            /** @brief HTCondor service (pool) each running job was submitted to */
+            std::map<std::shared_ptr<StandardJob>, std::shared_ptr<HTCondorComputeService>> running_jobs;
+            /** @brief Number of slots of each HTCondor pool */
+            std::map<std::shared_ptr<HTCondorComputeService>, unsigned long> pool_slots;
+            /** @brief Number of jobs dispatched to each HTCondor pool and not completed */
+            std::map<HTCondorComputeService *, unsigned long> pool_jobs;
+            /** @brief Submission, scheduling and completion dates of the tasks */
+            std::shared_ptr<TaskLifecycleTable> lifecycle_table;
+            /** @brief Counters of scheduled jobs and stage-in transfers */
+            std::shared_ptr<DAGManStatistics> statistics = std::make_shared<DAGManStatistics>();
+            /** @brief Whether jobs are placed on the pool holding most of their input data */
+            bool locality_aware_placement = false;
+            /** @brief Whether input files are staged in asynchronously */
+            bool asynchronous_stage_in = false;
+            /** @brief Maximum number of concurrent stage-in transfers (0 means unlimited) */
+            unsigned long max_concurrent_transfers = 0;
+            /** @brief Number of stage-in transfers in progress */
+            unsigned long running_transfers = 0;
+            /** @brief Stage-in transfers waiting to be initiated */
+            std::deque<Transfer> queued_transfers;
+            /** @brief Jobs waiting for each (file, destination storage service) transfer, queued or running */
+            std::map<std::pair<WorkflowFile *, StorageService *>, std::vector<unsigned long>> transfer_waiting_jobs;
+            /** @brief Jobs waiting for stage-in, indexed by a sequence number */
+            std::map<unsigned long, StagingJob> staging_jobs;
+            /** @brief Sequence number of the next job waiting for stage-in */
+            unsigned long next_staging_job_id = 0;
         };
 
     }
@@ -0,0 +1,83 @@
+/**
+ * Copyright (c) 2017-2021. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <fstream>
+
+#include "DAGManStatistics.h"
+
+namespace wrench {
+    namespace pegasus {
+
+        /**
+         * @brief Get the current wall-clock time
+         * @return the current wall-clock time point
+         */
+        DAGManStatistics::WallClock DAGManStatistics::now() {
+            return std::chrono::steady_clock::now();
+        }
+
+        /**
+         * @brief Get the wall-clock time elapsed since a time point
+         *
+         * @param start: the time point
+         * @return the elapsed wall-clock time in seconds
+         */
+        double DAGManStatistics::elapsed(const WallClock &start) {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        /**
+         * @brief Get the counters as JSON
+         * @return the counters, grouped by component
+         */
+        nlohmann::json DAGManStatistics::toJSON() const {
+            return {{"loop",      {{"iterations",              this->loop.iterations},
+                                   {"idle_iterations",         this->loop.idle_iterations},
+                                   {"scanned_jobs",            this->loop.scanned_jobs},
+                                   {"type_gated_jobs",         this->loop.type_gated_jobs},
+                                   {"category_throttled_jobs", this->loop.category_throttled_jobs},
+                                   {"register_throttled_jobs", this->loop.register_throttled_jobs},
+                                   {"submit_throttled_scans",  this->loop.submit_throttled_scans},
+                                   {"idle_throttled_scans",    this->loop.idle_throttled_scans},
+                                   {"submitted_jobs",          this->loop.submitted_jobs},
+                                   {"completed_jobs",          this->loop.completed_jobs},
+                                   {"notifications",           this->loop.notifications},
+                                   {"wait_timeouts",           this->loop.wait_timeouts},
+                                   {"wait_simulated_time",     this->loop.wait_simulated_time},
+                                   {"scan_wall_time",          this->loop.scan_wall_time},
+                                   {"completion_wall_time",    this->loop.completion_wall_time}}},
+                    {"scheduler", {{"calls",                   this->scheduler.calls},
+                                   {"immediate_jobs",          this->scheduler.immediate_jobs},
+                                   {"staging_jobs",            this->scheduler.staging_jobs},
+                                   {"synchronous_transfers",   this->scheduler.synchronous_transfers},
+                                   {"asynchronous_transfers",  this->scheduler.asynchronous_transfers},
+                                   {"stage_in_simulated_time", this->scheduler.stage_in_simulated_time},
+                                   {"wall_time",               this->scheduler.wall_time}}},
+                    {"monitor",   {{"job_completions",         this->monitor.job_completions},
+                                   {"file_copy_events",        this->monitor.file_copy_events},
+                                   {"notifications",           this->monitor.notifications},
+                                   {"coalesced_events",        this->monitor.coalesced_events}}}};
+        }
+
+        /**
+         * @brief Write the counters to a JSON file
+         *
+         * @param filename: the name of the file
+         *
+         * @throw std::runtime_error
+         */
+        void DAGManStatistics::write(const std::string &filename) const {
+            std::ofstream file(filename);
+            if (not file) {
+                throw std::runtime_error("DAGManStatistics::write(): Unable to write statistics file " + filename);
+            }
+            file << this->toJSON().dump(2) << "\n";
+        }
+    }
+}
@@ -0,0 +1,112 @@
+/**
+ * Copyright (c) 2017-2021. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef PEGASUS_DAGMANSTATISTICS_H
+#define PEGASUS_DAGMANSTATISTICS_H
+
+#include <chrono>
+#include <string>
+#include <nlohmann/json.hpp>
+
+namespace wrench {
+    namespace pegasus {
+
+        /**
+         * @brief Counters and time accumulators of the DAGMan scheduling loop, the DAGMan scheduler, and the
+         *        DAGMan monitor, used to tune throttles and spot pathological gating. Counters are plain fields
+         *        updated in place by their owner; simulated times are in seconds of simulated time, and wall
+         *        times in seconds of (steady) wall-clock time.
+         */
+        class DAGManStatistics {
+        public:
+            /** @brief A wall-clock time point */
+            typedef std::chrono::steady_clock::time_point WallClock;
+
+            static WallClock now();
+
+            static double elapsed(const WallClock &start);
+
+            nlohmann::json toJSON() const;
+
+            void write(const std::string &filename) const;
+
+            /**
+             * @brief Counters of the DAGMan scheduling loop (DAGMan::main())
+             */
+            struct Loop {
+                /** @brief Number of loop iterations */
+                unsigned long iterations = 0;
+                /** @brief Number of iterations in which no job was submitted or completed */
+                unsigned long idle_iterations = 0;
+                /** @brief Number of ready jobs scanned */
+                unsigned long scanned_jobs = 0;
+                /** @brief Number of ready jobs not scanned because of a different type than the running tasks */
+                unsigned long type_gated_jobs = 0;
+                /** @brief Number of ready jobs skipped by the per-category limit */
+                unsigned long category_throttled_jobs = 0;
+                /** @brief Number of scanned jobs skipped by the register job limit */
+                unsigned long register_throttled_jobs = 0;
+                /** @brief Number of scans stopped by the submit interval or maximum number of jobs */
+                unsigned long submit_throttled_scans = 0;
+                /** @brief Number of scans stopped by the maximum number of idle jobs */
+                unsigned long idle_throttled_scans = 0;
+                /** @brief Number of submitted jobs */
+                unsigned long submitted_jobs = 0;
+                /** @brief Number of completed jobs */
+                unsigned long completed_jobs = 0;
+                /** @brief Number of monitor notifications received (event-driven mode) */
+                unsigned long notifications = 0;
+                /** @brief Number of waits for a monitor notification that timed out (event-driven mode) */
+                unsigned long wait_timeouts = 0;
+                /** @brief Simulated time spent sleeping or waiting for monitor notifications */
+                double wait_simulated_time = 0;
+                /** @brief Wall-clock time spent scanning the ready queue */
+                double scan_wall_time = 0;
+                /** @brief Wall-clock time spent processing job completions */
+                double completion_wall_time = 0;
+            } loop;
+
+            /**
+             * @brief Counters of the DAGMan scheduler (DAGManScheduler::scheduleTasks())
+             */
+            struct Scheduler {
+                /** @brief Number of calls */
+                unsigned long calls = 0;
+                /** @brief Number of jobs submitted without waiting for stage-in */
+                unsigned long immediate_jobs = 0;
+                /** @brief Number of jobs waiting for asynchronous stage-in */
+                unsigned long staging_jobs = 0;
+                /** @brief Number of synchronous stage-in transfers */
+                unsigned long synchronous_transfers = 0;
+                /** @brief Number of asynchronous stage-in transfers initiated */
+                unsigned long asynchronous_transfers = 0;
+                /** @brief Simulated time blocked in synchronous stage-in transfers */
+                double stage_in_simulated_time = 0;
+                /** @brief Wall-clock time spent scheduling tasks (including synchronous stage-in) */
+                double wall_time = 0;
+            } scheduler;
+
+            /**
+             * @brief Counters of the DAGMan monitor
+             */
+            struct Monitor {
+                /** @brief Number of job completion events */
+                unsigned long job_completions = 0;
+                /** @brief Number of file copy (completion or failure) events */
+                unsigned long file_copy_events = 0;
+                /** @brief Number of notifications sent to DAGMan */
+                unsigned long notifications = 0;
+                /** @brief Number of events coalesced into a pending notification */
+                unsigned long coalesced_events = 0;
+            } monitor;
+        };
+    }
+}
+
+#endif //PEGASUS_DAGMANSTATISTICS_H
@@ -0,0 +1,222 @@
+/**
+ * Copyright (c) 2017-2021. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <set>
+#include <stdexcept>
+
+#include "DAGManThrottle.h"
+
+namespace wrench {
+    namespace pegasus {
+
+        /**
+         * @brief Constructor
+         *
+         * @param max_jobs: maximum number of jobs submitted and not completed (DAGMan -maxjobs)
+         * @param max_idle: maximum number of submitted jobs that have not started (DAGMAN_MAX_JOBS_IDLE)
+         * @param max_submits_per_interval: maximum number of jobs submitted per scan interval
+         *                                  (DAGMAN_MAX_SUBMITS_PER_INTERVAL)
+         * @param submit_interval: time between two DAGMan scans, in seconds
+         * @param bootstrap_delay: DAGMan start-up delay, in seconds
+         * @param max_register_jobs: maximum number of concurrent register jobs
+         * @param category_max_jobs: maximum number of running jobs per category (CATEGORY/MAXJOBS)
+         *
+         * @throw std::invalid_argument
+         */
+        DAGManThrottle::DAGManThrottle(unsigned long max_jobs,
+                                       unsigned long max_idle,
+                                       unsigned long max_submits_per_interval,
+                                       double submit_interval,
+                                       double bootstrap_delay,
+                                       unsigned long max_register_jobs,
+                                       const std::map<std::string, unsigned long> &category_max_jobs) :
+                max_jobs(max_jobs), max_idle(max_idle), max_submits_per_interval(max_submits_per_interval),
+                submit_interval(submit_interval), bootstrap_delay(bootstrap_delay),
+                max_register_jobs(max_register_jobs), category_max_jobs(category_max_jobs) {
+            if (submit_interval <= 0) {
+                throw std::invalid_argument("DAGManThrottle::DAGManThrottle(): submit interval must be positive");
+            }
+            if (bootstrap_delay < 0) {
+                throw std::invalid_argument("DAGManThrottle::DAGManThrottle(): bootstrap delay must be non-negative");
+            }
+        }
+
+        /**
+         * @brief Get the maximum number of jobs submitted and not completed
+         * @return the limit (0 if unlimited)
+         */
+        unsigned long DAGManThrottle::getMaxJobs() const {
+            return this->max_jobs;
+        }
+
+        /**
+         * @brief Get the maximum number of submitted jobs that have not started
+         * @return the limit (0 if unlimited)
+         */
+        unsigned long DAGManThrottle::getMaxIdle() const {
+            return this->max_idle;
+        }
+
+        /**
+         * @brief Get the maximum number of jobs submitted per scan interval
+         * @return the limit (0 if unlimited)
+         */
+        unsigned long DAGManThrottle::getMaxSubmitsPerInterval() const {
+            return this->max_submits_per_interval;
+        }
+
+        /**
+         * @brief Get the time between two DAGMan scans
+         * @return the scan interval in seconds
+         */
+        double DAGManThrottle::getSubmitInterval() const {
+            return this->submit_interval;
+        }
+
+        /**
+         * @brief Get the DAGMan start-up delay
+         * @return the delay in seconds
+         */
+        double DAGManThrottle::getBootstrapDelay() const {
+            return this->bootstrap_delay;
+        }
+
+        /**
+         * @brief Get the maximum number of concurrent register jobs
+         * @return the limit (0 if unlimited)
+         */
+        unsigned long DAGManThrottle::getMaxRegisterJobs() const {
+            return this->max_register_jobs;
+        }
+
+        /**
+         * @brief Get the maximum number of running jobs for a category
+         *
+         * @param category: the job category (transformation)
+         * @return the limit (0 if unlimited)
+         */
+        unsigned long DAGManThrottle::getCategoryMaxJobs(const std::string &category) const {
+            auto it = this->category_max_jobs.find(category);
+            return it == this->category_max_jobs.end() ? 0 : it->second;
+        }
+
+        /**
+         * @brief Resolve the per-category limits for the categories of a workflow. Limits are keyed by
+         *        category name, i.e., the transformation (e.g., "mProjectPP") or, for tasks without one, the
+         *        canonical ID prefix (e.g., "stage_in"), or by type name (e.g., "stage"). Running job counts
+         *        of known categories are kept, so that categories can be added as sub-workflows are expanded.
+         *
+         * @param categories: the workflow task categories
+         */
+        void DAGManThrottle::setCategories(const TaskCategoryRegistry &categories) {
+            this->category_limits.assign(categories.getNumberOfCategories(), 0);
+            this->running_jobs_per_category.resize(categories.getNumberOfCategories(), 0);
+            for (unsigned int category = 0; category < categories.getNumberOfCategories(); category++) {
+                unsigned long limit = this->getCategoryMaxJobs(categories.getCategoryName(category));
+                if (limit == 0) {
+                    limit = this->getCategoryMaxJobs(categories.getTypeName(categories.getCategoryType(category)));
+                }
+                this->category_limits[category] = limit;
+            }
+        }
+
+        /**
+         * @brief Get the per-category limit keys that match neither a category nor a type of a workflow
+         *
+         * @param categories: the workflow task categories
+         * @return the unknown keys
+         */
+        std::vector<std::string> DAGManThrottle::getUnknownCategories(const TaskCategoryRegistry &categories) const {
+            std::set<std::string> names;
+            for (unsigned int category = 0; category < categories.getNumberOfCategories(); category++) {
+                names.insert(categories.getCategoryName(category));
+                names.insert(categories.getTypeName(categories.getCategoryType(category)));
+            }
+            std::vector<std::string> unknown_categories;
+            for (auto &category_max_jobs : this->category_max_jobs) {
+                if (names.find(category_max_jobs.first) == names.end()) {
+                    unknown_categories.push_back(category_max_jobs.first);
+                }
+            }
+            return unknown_categories;
+        }
+
+        /**
+         * @brief Check whether no more jobs can be submitted in the current scan interval
+         *
+         * @param submitted_jobs: number of jobs already submitted in the current interval
+         * @return true if the interval is full
+         */
+        bool DAGManThrottle::isSubmitIntervalFull(unsigned long submitted_jobs) const {
+            return this->max_submits_per_interval > 0 && submitted_jobs >= this->max_submits_per_interval;
+        }
+
+        /**
+         * @brief Check whether the maximum number of running jobs has been reached
+         * @return true if no more jobs can be submitted
+         */
+        bool DAGManThrottle::isMaxJobsReached() const {
+            return this->max_jobs > 0 && this->running_jobs >= this->max_jobs;
+        }
+
+        /**
+         * @brief Check whether the maximum number of idle jobs has been reached
+         *
+         * @param idle_jobs: number of submitted jobs that have not started
+         * @return true if no more jobs can be submitted
+         */
+        bool DAGManThrottle::isMaxIdleReached(unsigned long idle_jobs) const {
+            return this->max_idle > 0 && idle_jobs >= this->max_idle;
+        }
+
+        /**
+         * @brief Check whether the maximum number of running jobs for a category has been reached
+         *
+         * @param category: the job category ID
+         * @return true if no more jobs of this category can be submitted
+         */
+        bool DAGManThrottle::isCategoryFull(unsigned int category) const {
+            unsigned long limit = this->category_limits[category];
+            return limit > 0 && this->running_jobs_per_category[category] >= limit;
+        }
+
+        /**
+         * @brief Account for a submitted job
+         *
+         * @param category: the job category ID
+         */
+        void DAGManThrottle::notifyJobSubmitted(unsigned int category) {
+            this->running_jobs++;
+            this->running_jobs_per_category[category]++;
+        }
+
+        /**
+         * @brief Account for a completed job
+         *
+         * @param category: the job category ID
+         *
+         * @throw std::runtime_error
+         */
+        void DAGManThrottle::notifyJobCompleted(unsigned int category) {
+            if (this->running_jobs == 0 || this->running_jobs_per_category[category] == 0) {
+                throw std::runtime_error("DAGManThrottle::notifyJobCompleted(): no running job for this category");
+            }
+            this->running_jobs--;
+            this->running_jobs_per_category[category]--;
+        }
+
+        /**
+         * @brief Get the number of jobs submitted and not completed
+         * @return number of running jobs
+         */
+        unsigned long DAGManThrottle::getRunningJobs() const {
+            return this->running_jobs;
+        }
+    }
+}
@@ -0,0 +1,95 @@
+/**
+ * Copyright (c) 2017-2021. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef PEGASUS_DAGMANTHROTTLE_H
+#define PEGASUS_DAGMANTHROTTLE_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "TaskCategoryRegistry.h"
+
+namespace wrench {
+    namespace pegasus {
+
+        /**
+         * @brief DAGMan job throttling settings (MAXJOBS, DAGMAN_MAX_JOBS_IDLE, DAGMAN_MAX_SUBMITS_PER_INTERVAL,
+         *        CATEGORY/MAXJOBS, etc.) and the bookkeeping of running jobs needed to enforce them.
+         *        A limit of 0 means unlimited.
+         */
+        class DAGManThrottle {
+        public:
+            DAGManThrottle(unsigned long max_jobs = 0,
+                           unsigned long max_idle = 0,
+                           unsigned long max_submits_per_interval = 5,
+                           double submit_interval = 0.1,
+                           double bootstrap_delay = 3.0,
+                           unsigned long max_register_jobs = 1,
+                           const std::map<std::string, unsigned long> &category_max_jobs = {});
+
+            unsigned long getMaxJobs() const;
+
+            unsigned long getMaxIdle() const;
+
+            unsigned long getMaxSubmitsPerInterval() const;
+
+            double getSubmitInterval() const;
+
+            double getBootstrapDelay() const;
+
+            unsigned long getMaxRegisterJobs() const;
+
+            unsigned long getCategoryMaxJobs(const std::string &category) const;
+
+            void setCategories(const TaskCategoryRegistry &categories);
+
+            std::vector<std::string> getUnknownCategories(const TaskCategoryRegistry &categories) const;
+
+            bool isSubmitIntervalFull(unsigned long submitted_jobs) const;
+
+            bool isMaxJobsReached() const;
+
+            bool isMaxIdleReached(unsigned long idle_jobs) const;
+
+            bool isCategoryFull(unsigned int category) const;
+
+            void notifyJobSubmitted(unsigned int category);
+
+            void notifyJobCompleted(unsigned int category);
+
+            unsigned long getRunningJobs() const;
+
+        private:
+            /** @brief Maximum number of jobs submitted and not completed */
+            unsigned long max_jobs;
+            /** @brief Maximum number of submitted jobs that have not started */
+            unsigned long max_idle;
+            /** @brief Maximum number of jobs submitted per scan interval */
+            unsigned long max_submits_per_interval;
+            /** @brief Time between two DAGMan scans (seconds) */
+            double submit_interval;
+            /** @brief DAGMan start-up delay (seconds) */
+            double bootstrap_delay;
+            /** @brief Maximum number of concurrent register jobs */
+            unsigned long max_register_jobs;
+            /** @brief Maximum number of running jobs per category (transformation) */
+            std::map<std::string, unsigned long> category_max_jobs;
+
+            /** @brief Number of jobs submitted and not completed */
+            unsigned long running_jobs = 0;
+            /** @brief Maximum number of running jobs, indexed by category ID */
+            std::vector<unsigned long> category_limits;
+            /** @brief Number of jobs submitted and not completed, indexed by category ID */
+            std::vector<unsigned long> running_jobs_per_category;
+        };
+    }
+}
+
+#endif //PEGASUS_DAGMANTHROTTLE_H
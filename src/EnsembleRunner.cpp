@@ -0,0 +1,190 @@
+/**
+ * Copyright (c) 2017-2021. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <nlohmann/json.hpp>
+
+#include "EnsembleRunner.h"
+
+namespace wrench {
+    namespace pegasus {
+
+        /**
+         * @brief Constructor
+         *
+         * @param replicas: the number of replicas
+         * @param seed: the seed of the first replica (replica i uses seed + i)
+         * @param output_dir: the directory replica outputs and the ensemble summary are written to
+         * @param args: the simulator arguments of the scenario (platform, workflow, config, and options). Output
+         *              files (--trace, --statistics, and --profile) are written per replica, to
+         *              <output_dir>/replica-<i>-<file name>; --rescue is not supported, as replicas would share
+         *              the rescue file
+         *
+         * @throw std::invalid_argument
+         */
+        EnsembleRunner::EnsembleRunner(unsigned long replicas, unsigned long seed, const std::string &output_dir,
+                                       const std::vector<std::string> &args) :
+                replicas(replicas), seed(seed), output_dir(output_dir), sweep_runner(0, output_dir) {
+            if (replicas == 0) {
+                throw std::invalid_argument("EnsembleRunner::EnsembleRunner(): The number of replicas must be > 0");
+            }
+            for (auto &arg : args) {
+                if (arg.find("--rescue=") == 0) {
+                    throw std::invalid_argument(
+                            "EnsembleRunner::EnsembleRunner(): --rescue is not supported in ensemble mode");
+                }
+            }
+
+            std::vector<std::string> output_options = {"--trace=", "--statistics=", "--profile="};
+            for (unsigned long i = 0; i < replicas; i++) {
+                std::string name = "replica-" + std::to_string(i);
+                std::vector<std::string> replica_args;
+                for (auto &arg : args) {
+                    if (arg.find("--summary=") == 0) {
+                        // replaced by the replica summary below
+                        continue;
+                    }
+                    std::string replica_arg = arg;
+                    for (auto &option : output_options) {
+                        if (arg.find(option) == 0) {
+                            // concurrent replicas must not write the same file (the file name keeps its extension,
+                            // which selects the trace format)
+                            std::string path = arg.substr(option.size());
+                            std::string basename = path.substr(path.find_last_of('/') + 1);
+                            replica_arg = option + output_dir + "/" + name + "-" + basename;
+                        }
+                    }
+                    replica_args.push_back(replica_arg);
+                }
+                replica_args.push_back("--perturbation-seed=" + std::to_string(seed + i));
+                replica_args.push_back("--summary=" + output_dir + "/" + name + ".json");
+                this->sweep_runner.addScenario(name, replica_args);
+            }
+        }
+
+        /**
+         * @brief Run all replicas, then write the percentiles of their makespan, energy, and task durations per
+         *        category to the ensemble summary (ensemble.json in the output directory) and the standard error
+         *
+         * @param executable: the simulator executable
+         * @return the number of replicas that failed
+         *
+         * @throw std::runtime_error
+         */
+        int EnsembleRunner::run(const std::string &executable) {
+            int failed = this->sweep_runner.run(executable);
+
+            // collecting replica summaries (failed replicas have none)
+            std::vector<double> makespans;
+            std::vector<double> energies;
+            std::map<std::string, std::vector<double>> durations;
+            for (unsigned long i = 0; i < this->replicas; i++) {
+                std::ifstream file(this->output_dir + "/replica-" + std::to_string(i) + ".json");
+                if (not file) {
+                    continue;
+                }
+                nlohmann::json summary;
+                try {
+                    file >> summary;
+                    makespans.push_back(summary.at("makespan").get<double>());
+                    if (summary.find("energy") != summary.end()) {
+                        energies.push_back(summary.at("energy").get<double>());
+                    }
+                    for (auto &category : summary.at("task_durations").items()) {
+                        auto &category_durations = durations[category.key()];
+                        for (auto &duration : category.value()) {
+                            category_durations.push_back(duration.get<double>());
+                        }
+                    }
+                } catch (nlohmann::json::exception &e) {
+                    std::cerr << "Ignoring invalid summary of replica " << i << ": " << e.what() << std::endl;
+                }
+            }
+
+            std::vector<double> percentiles = {5, 25, 50, 75, 95};
+            auto summarize = [&percentiles](std::vector<double> &values) {
+                std::sort(values.begin(), values.end());
+                nlohmann::json json_percentiles;
+                for (double p : percentiles) {
+                    json_percentiles["p" + std::to_string((int) p)] = percentile(values, p);
+                }
+                double sum = 0;
+                for (double value : values) {
+                    sum += value;
+                }
+                return nlohmann::json({{"count",       values.size()},
+                                       {"mean",        values.empty() ? 0 : sum / values.size()},
+                                       {"min",         values.empty() ? 0 : values.front()},
+                                       {"max",         values.empty() ? 0 : values.back()},
+                                       {"percentiles", json_percentiles}});
+            };
+
+            nlohmann::json json_durations;
+            for (auto &category : durations) {
+                json_durations[category.first] = summarize(category.second);
+            }
+            nlohmann::json ensemble = {{"replicas",       this->replicas},
+                                       {"succeeded",      makespans.size()},
+                                       {"seed",           this->seed},
+                                       {"makespan",       summarize(makespans)},
+                                       {"task_durations", json_durations}};
+            if (not energies.empty()) {
+                ensemble["energy"] = summarize(energies);
+            }
+
+            std::string filename = this->output_dir + "/ensemble.json";
+            std::ofstream file(filename);
+            if (not file) {
+                throw std::runtime_error("EnsembleRunner::run(): Unable to write ensemble summary " + filename);
+            }
+            file << ensemble.dump(2) << "\n";
+
+            std::cerr << "=== WRENCH-Pegasus: Ensemble Summary (" << makespans.size() << "/" << this->replicas
+                      << " replicas)" << std::endl;
+            std::cerr << "metric,p5,p25,p50,p75,p95\n";
+            auto print = [](const std::string &metric, const nlohmann::json &summary) {
+                auto &p = summary.at("percentiles");
+                std::cerr << metric << "," << p.at("p5") << "," << p.at("p25") << "," << p.at("p50") << ","
+                          << p.at("p75") << "," << p.at("p95") << "\n";
+            };
+            print("makespan", ensemble.at("makespan"));
+            if (not energies.empty()) {
+                print("energy", ensemble.at("energy"));
+            }
+            for (auto &category : json_durations.items()) {
+                print("duration:" + category.key(), category.value());
+            }
+            std::cerr.flush();
+
+            return failed;
+        }
+
+        /**
+         * @brief Get a percentile of a set of values, interpolating linearly between closest ranks
+         *
+         * @param sorted_values: the values, in increasing order
+         * @param p: the percentile (between 0 and 100)
+         * @return the percentile (0 if there are no values)
+         */
+        double EnsembleRunner::percentile(const std::vector<double> &sorted_values, double p) {
+            if (sorted_values.empty()) {
+                return 0;
+            }
+            double rank = p / 100 * (sorted_values.size() - 1);
+            auto lower = (unsigned long) rank;
+            if (lower + 1 >= sorted_values.size()) {
+                return sorted_values.back();
+            }
+            return sorted_values[lower] + (rank - lower) * (sorted_values[lower + 1] - sorted_values[lower]);
+        }
+    }
+}
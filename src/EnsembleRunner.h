@@ -0,0 +1,48 @@
+/**
+ * Copyright (c) 2017-2021. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef PEGASUS_ENSEMBLERUNNER_H
+#define PEGASUS_ENSEMBLERUNNER_H
+
+#include <string>
+#include <vector>
+
+#include "SweepRunner.h"
+
+namespace wrench {
+    namespace pegasus {
+
+        /**
+         * @brief Runs a Monte-Carlo ensemble of a scenario: each replica is simulated in its own process, with
+         *        task flops and file sizes perturbed using a distinct seed, and the makespan, energy, and task
+         *        durations per category of all replicas are summarized as percentiles.
+         */
+        class EnsembleRunner {
+        public:
+            EnsembleRunner(unsigned long replicas, unsigned long seed, const std::string &output_dir,
+                           const std::vector<std::string> &args);
+
+            int run(const std::string &executable);
+
+        private:
+            static double percentile(const std::vector<double> &sorted_values, double p);
+
+            /** @brief Number of replicas */
+            unsigned long replicas;
+            /** @brief Seed of the first replica (replica i uses seed + i) */
+            unsigned long seed;
+            /** @brief Directory replica outputs and the ensemble summary are written to */
+            std::string output_dir;
+            /** @brief Runner of the replica processes */
+            SweepRunner sweep_runner;
+        };
+    }
+}
+
+#endif //PEGASUS_ENSEMBLERUNNER_H
@@ -0,0 +1,112 @@
+/**
+ * Copyright (c) 2017-2021. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <algorithm>
+#include <fnmatch.h>
+
+#include "InputPlacement.h"
+
+XBT_LOG_NEW_DEFAULT_CATEGORY(InputPlacement, "Log category for InputPlacement");
+
+namespace wrench {
+    namespace pegasus {
+
+        /**
+         * @brief Constructor
+         *
+         * @param patterns: file ID patterns (shell wildcards) of the files placed on each site, indexed by hostname
+         * @param policy: the placement of files matching no pattern ("all" or "round_robin")
+         * @param replicas: the number of sites each file matching no pattern is placed on (round-robin policy)
+         *
+         * @throw std::invalid_argument
+         */
+        InputPlacement::InputPlacement(const std::map<std::string, std::vector<std::string>> &patterns,
+                                       const std::string &policy, unsigned long replicas) :
+                patterns(patterns), replicas(replicas) {
+            if (policy != "all" && policy != "round_robin") {
+                throw std::invalid_argument("InputPlacement::InputPlacement(): Invalid policy " + policy +
+                                            " (should be all or round_robin)");
+            }
+            if (replicas == 0) {
+                throw std::invalid_argument("InputPlacement::InputPlacement(): Invalid number of replicas (0)");
+            }
+            this->round_robin = policy == "round_robin";
+        }
+
+        /**
+         * @brief Stage input files on the sites they are placed on (which also registers them in the file
+         *        registry service)
+         *
+         * @param simulation: the simulation (not launched yet)
+         * @param files: the input files
+         * @param storage_services: the storage services of the sites, indexed by hostname
+         * @return the number of staged replicas
+         *
+         * @throw std::invalid_argument
+         */
+        unsigned long InputPlacement::stage(Simulation &simulation, const std::vector<WorkflowFile *> &files,
+                                            const std::map<std::string, std::shared_ptr<StorageService>> &storage_services) const {
+            std::vector<std::shared_ptr<StorageService>> sites;
+            for (auto &storage_service : storage_services) {
+                sites.push_back(storage_service.second);
+            }
+            if (sites.empty()) {
+                throw std::invalid_argument("InputPlacement::stage(): No storage service");
+            }
+
+            // pattern sites are resolved once, rather than for each file
+            std::vector<std::pair<std::shared_ptr<StorageService>, const std::vector<std::string> *>> pattern_sites;
+            for (auto &site_patterns : this->patterns) {
+                auto storage_service = storage_services.find(site_patterns.first);
+                if (storage_service == storage_services.end()) {
+                    throw std::invalid_argument("InputPlacement::stage(): Unknown storage host " +
+                                                site_patterns.first);
+                }
+                pattern_sites.push_back(std::make_pair(storage_service->second, &site_patterns.second));
+            }
+
+            unsigned long staged_replicas = 0;
+            unsigned long next_site = 0;
+            for (auto file : files) {
+                bool matched = false;
+                for (auto &pattern_site : pattern_sites) {
+                    for (auto &pattern : *pattern_site.second) {
+                        if (fnmatch(pattern.c_str(), file->getID().c_str(), 0) == 0) {
+                            simulation.stageFile(file, pattern_site.first);
+                            staged_replicas++;
+                            matched = true;
+                            break;
+                        }
+                    }
+                }
+                if (matched) {
+                    continue;
+                }
+
+                if (not this->round_robin) {
+                    for (auto &site : sites) {
+                        simulation.stageFile(file, site);
+                    }
+                    staged_replicas += sites.size();
+                } else {
+                    unsigned long file_replicas = std::min<unsigned long>(this->replicas, sites.size());
+                    for (unsigned long i = 0; i < file_replicas; i++) {
+                        simulation.stageFile(file, sites[(next_site + i) % sites.size()]);
+                    }
+                    next_site = (next_site + 1) % sites.size();
+                    staged_replicas += file_replicas;
+                }
+            }
+
+            WRENCH_INFO("Staged %ld input files (%ld replicas) on %ld storage services", files.size(),
+                        staged_replicas, sites.size());
+            return staged_replicas;
+        }
+    }
+}
@@ -0,0 +1,47 @@
+/**
+ * Copyright (c) 2017-2021. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef PEGASUS_INPUTPLACEMENT_H
+#define PEGASUS_INPUTPLACEMENT_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include <wrench-dev.h>
+
+namespace wrench {
+    namespace pegasus {
+
+        /**
+         * @brief Placement of the workflow input files on the storage hosts (sites) before the simulation starts:
+         *        files are staged in a single pass, each only on the sites that serve it, rather than on every
+         *        site. A file is placed on the sites whose file ID patterns match it or, if none does, according
+         *        to the default policy: on every site ("all") or on a given number of sites in turn
+         *        ("round_robin").
+         */
+        class InputPlacement {
+        public:
+            InputPlacement(const std::map<std::string, std::vector<std::string>> &patterns = {},
+                           const std::string &policy = "all", unsigned long replicas = 1);
+
+            unsigned long stage(Simulation &simulation, const std::vector<WorkflowFile *> &files,
+                                const std::map<std::string, std::shared_ptr<StorageService>> &storage_services) const;
+
+        private:
+            /** @brief File ID patterns (shell wildcards) of the files placed on each site, indexed by hostname */
+            std::map<std::string, std::vector<std::string>> patterns;
+            /** @brief Whether files matching no pattern are placed on sites in turn (otherwise on every site) */
+            bool round_robin;
+            /** @brief Number of sites each file matching no pattern is placed on (round-robin policy) */
+            unsigned long replicas;
+        };
+    }
+}
+
+#endif //PEGASUS_INPUTPLACEMENT_H
@@ -0,0 +1,163 @@
+/**
+ * Copyright (c) 2017-2021. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include "JobClustering.h"
+
+XBT_LOG_NEW_DEFAULT_CATEGORY(JobClustering, "Log category for JobClustering");
+
+namespace wrench {
+    namespace pegasus {
+
+        /**
+         * @brief Constructor, which computes the clusters of a workflow
+         *
+         * @param workflow_index: the index of the workflow
+         * @param settings: clustering settings per task category (tasks of other categories are not clustered)
+         */
+        JobClustering::JobClustering(const WorkflowIndex &workflow_index,
+                                     const std::map<std::string, Settings> &settings) : settings(settings) {
+            this->cluster_offsets.push_back(0);
+            this->cluster(workflow_index);
+        }
+
+        /**
+         * @brief Compute the clusters of the tasks appended to the workflow index since the last call (e.g., the
+         *        tasks of an expanded sub-workflow). Clusters of already clustered tasks are left unchanged.
+         *
+         * @param workflow_index: the index of the workflow
+         */
+        void JobClustering::cluster(const WorkflowIndex &workflow_index) {
+            auto &categories = workflow_index.getCategories();
+            unsigned long first = this->task_clusters.size();
+            unsigned long num_tasks = workflow_index.getNumberOfTasks();
+
+            // settings indexed by category ID
+            std::vector<Settings> category_settings(categories.getNumberOfCategories(), Settings{0, 0});
+            for (unsigned int category = 0; category < categories.getNumberOfCategories(); category++) {
+                auto it = this->settings.find(categories.getCategoryName(category));
+                if (it != this->settings.end()) {
+                    category_settings[category] = it->second;
+                }
+            }
+
+            // group clustered tasks by (category, level), in dense ID order
+            std::map<std::pair<unsigned int, unsigned long>, std::vector<unsigned long>> groups;
+            for (unsigned long id = first; id < num_tasks; id++) {
+                unsigned int category = categories.getTaskCategory(id);
+                if (category_settings[category].size > 1 || category_settings[category].num > 0) {
+                    groups[std::make_pair(category, workflow_index.getTopLevel(id))].push_back(id);
+                }
+            }
+
+            // split groups into clusters, each cluster being identified by its first task
+            std::vector<unsigned long> leaders(num_tasks - first);
+            for (unsigned long id = first; id < num_tasks; id++) {
+                leaders[id - first] = id;
+            }
+            for (auto &group : groups) {
+                auto &tasks = group.second;
+                auto &setting = category_settings[group.first.first];
+                unsigned long num_clusters = setting.num > 0
+                                             ? std::min<unsigned long>(setting.num, tasks.size())
+                                             : (tasks.size() + setting.size - 1) / setting.size;
+                unsigned long start = 0;
+                for (unsigned long c = 0; c < num_clusters; c++) {
+                    // balanced split: cluster sizes differ by at most one task
+                    unsigned long end = start + tasks.size() / num_clusters + (c < tasks.size() % num_clusters ? 1 : 0);
+                    for (unsigned long i = start; i < end; i++) {
+                        leaders[tasks[i] - first] = tasks[start];
+                    }
+                    start = end;
+                }
+            }
+
+            // number clusters in order of their leaders
+            unsigned long first_cluster = this->getNumberOfClusters();
+            std::vector<unsigned long> leader_clusters(num_tasks - first, 0);
+            std::vector<unsigned long> cluster_sizes;
+            this->task_clusters.resize(num_tasks);
+            for (unsigned long id = first; id < num_tasks; id++) {
+                if (leaders[id - first] == id) {
+                    leader_clusters[id - first] = first_cluster + cluster_sizes.size();
+                    cluster_sizes.push_back(0);
+                    this->cluster_priorities.push_back(workflow_index.getPriority(id));
+                }
+            }
+            for (unsigned long id = first; id < num_tasks; id++) {
+                unsigned long cluster = leader_clusters[leaders[id - first] - first];
+                this->task_clusters[id] = cluster;
+                cluster_sizes[cluster - first_cluster]++;
+                this->cluster_priorities[cluster] = std::max(this->cluster_priorities[cluster],
+                                                             workflow_index.getPriority(id));
+            }
+
+            // cluster tasks (CSR)
+            for (unsigned long size : cluster_sizes) {
+                this->cluster_offsets.push_back(this->cluster_offsets.back() + size);
+            }
+            this->cluster_tasks.resize(num_tasks);
+            std::vector<unsigned long> next_task(this->cluster_offsets.begin() + first_cluster,
+                                                 this->cluster_offsets.end() - 1);
+            for (unsigned long id = first; id < num_tasks; id++) {
+                this->cluster_tasks[next_task[this->task_clusters[id] - first_cluster]++] = id;
+            }
+
+            WRENCH_INFO("Clustered %lu tasks into %lu jobs", num_tasks - first, cluster_sizes.size());
+        }
+
+        /**
+         * @brief Get the number of clusters (i.e., of jobs)
+         * @return number of clusters
+         */
+        unsigned long JobClustering::getNumberOfClusters() const {
+            return this->cluster_priorities.size();
+        }
+
+        /**
+         * @brief Get the cluster of a task
+         *
+         * @param id: a task dense ID
+         * @return the cluster ID
+         */
+        unsigned long JobClustering::getTaskCluster(unsigned long id) const {
+            return this->task_clusters[id];
+        }
+
+        /**
+         * @brief Get the tasks of a cluster
+         *
+         * @param cluster: a cluster ID
+         * @return a range of task dense IDs, in ascending order
+         */
+        WorkflowIndex::Range JobClustering::getClusterTasks(unsigned long cluster) const {
+            const unsigned long *base = this->cluster_tasks.data();
+            return {base + this->cluster_offsets[cluster], base + this->cluster_offsets[cluster + 1]};
+        }
+
+        /**
+         * @brief Get the task that identifies a cluster (its first task)
+         *
+         * @param cluster: a cluster ID
+         * @return a task dense ID
+         */
+        unsigned long JobClustering::getClusterLeader(unsigned long cluster) const {
+            return this->cluster_tasks[this->cluster_offsets[cluster]];
+        }
+
+        /**
+         * @brief Get the priority of a cluster
+         *
+         * @param cluster: a cluster ID
+         * @return the highest priority among the cluster tasks
+         */
+        long JobClustering::getClusterPriority(unsigned long cluster) const {
+            return this->cluster_priorities[cluster];
+        }
+    }
+}
@@ -0,0 +1,67 @@
+/**
+ * Copyright (c) 2017-2021. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef PEGASUS_JOBCLUSTERING_H
+#define PEGASUS_JOBCLUSTERING_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "WorkflowIndex.h"
+
+namespace wrench {
+    namespace pegasus {
+
+        /**
+         * @brief Pegasus-style horizontal clustering: tasks of the same category and level are grouped into
+         *        clustered jobs, so that a single HTCondor job runs several tasks. Tasks of categories that are
+         *        not clustered form singleton clusters.
+         */
+        class JobClustering {
+        public:
+            /**
+             * @brief Clustering settings of a category (Pegasus clusters.size and clusters.num profiles)
+             */
+            struct Settings {
+                /** @brief Maximum number of tasks per clustered job (0 if not set) */
+                unsigned long size;
+                /** @brief Number of clustered jobs per level (0 if not set), has precedence over size */
+                unsigned long num;
+            };
+
+            JobClustering(const WorkflowIndex &workflow_index, const std::map<std::string, Settings> &settings = {});
+
+            void cluster(const WorkflowIndex &workflow_index);
+
+            unsigned long getNumberOfClusters() const;
+
+            unsigned long getTaskCluster(unsigned long id) const;
+
+            WorkflowIndex::Range getClusterTasks(unsigned long cluster) const;
+
+            unsigned long getClusterLeader(unsigned long cluster) const;
+
+            long getClusterPriority(unsigned long cluster) const;
+
+        private:
+            /** @brief Clustering settings per task category */
+            std::map<std::string, Settings> settings;
+            /** @brief Cluster of each task, indexed by dense task ID */
+            std::vector<unsigned long> task_clusters;
+            /** @brief CSR offsets and values for the tasks of each cluster */
+            std::vector<unsigned long> cluster_offsets;
+            std::vector<unsigned long> cluster_tasks;
+            /** @brief Priority of each cluster (highest priority among its tasks) */
+            std::vector<long> cluster_priorities;
+        };
+    }
+}
+
+#endif //PEGASUS_JOBCLUSTERING_H
@@ -0,0 +1,60 @@
+/**
+ * Copyright (c) 2017-2021. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <iostream>
+#include <string>
+#include <wrench-dev.h>
+#include <wrench/tools/pegasus/PegasusWorkflowParser.h>
+
+#include "TaskCategoryRegistry.h"
+#include "WorkflowCache.h"
+
+/**
+ * Converts DAX or JSON workflow files into binary pre-parsed workflows (*.wpc), stored next to the workflow files
+ * and loaded by wrench-pegasus-run instead of parsing them.
+ */
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        std::cerr << "WRENCH Pegasus workflow cache converter" << std::endl;
+        std::cerr << "Usage: " << argv[0] << " <JSON or XML workflow file> [<JSON or XML workflow file> ...]"
+                  << std::endl;
+        exit(1);
+    }
+
+    int failed = 0;
+    for (int i = 1; i < argc; i++) {
+        std::string workflow_file = argv[i];
+        std::string extension = workflow_file.substr(workflow_file.find_last_of('.') + 1);
+        try {
+            wrench::Workflow *workflow;
+            wrench::pegasus::TaskCategoryRegistry::TransformationMap transformations;
+            if (extension == "xml") {
+                workflow = wrench::PegasusWorkflowParser::createWorkflowFromDAX(workflow_file, "1f");
+                transformations = wrench::pegasus::TaskCategoryRegistry::readTransformations(workflow_file);
+            } else if (extension == "json") {
+                workflow = wrench::PegasusWorkflowParser::createWorkflowFromJSON(workflow_file, "1f");
+            } else {
+                std::cerr << "Invalid workflow file name " << workflow_file << " (should be *.xml or *.json)\n";
+                failed++;
+                continue;
+            }
+
+            std::string cache_file = wrench::pegasus::WorkflowCache::getCacheFilename(workflow_file);
+            wrench::pegasus::WorkflowCache::write(workflow, cache_file, workflow_file, transformations);
+            std::cerr << workflow_file << ": " << workflow->getNumberOfTasks() << " tasks written to "
+                      << cache_file << std::endl;
+            delete workflow;
+        } catch (std::exception &e) {
+            std::cerr << workflow_file << ": " << e.what() << std::endl;
+            failed++;
+        }
+    }
+
+    return failed == 0 ? 0 : 1;
+}
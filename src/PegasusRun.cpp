@@ -7,164 +7,385 @@
  * (at your option) any later version.
  */
 
+#include <algorithm>
+#include <fstream>
 #include <iostream>
 #include <vector>
+#include <nlohmann/json.hpp>
 #include <wrench-dev.h>
 #include <wrench/tools/pegasus/PegasusWorkflowParser.h>
 
 #include "DAGMan.h"
+#include "EnsembleRunner.h"
 #include "PegasusSimulationTimestampTypes.h"
+#include "PhaseProfiler.h"
+#include "RescueDAG.h"
 #include "SimulationConfig.h"
+#include "SubWorkflowExpander.h"
+#include "SweepRunner.h"
+#include "TaskTraceSink.h"
+#include "WorkflowCache.h"
+#include "WorkflowIndex.h"
 
 XBT_LOG_NEW_DEFAULT_CATEGORY(PegasusRun, "Log category for PegasusRun");
 
 int main(int argc, char **argv) {
+    // sweep and ensemble modes: each scenario of the manifest (or replica) is simulated by a separate process
+    std::string sweep_manifest;
+    unsigned long replicas = 0;
+    unsigned long seed = 0;
+    std::string ensemble_output = "ensemble";
+    std::vector<std::string> scenario_args;
+    try {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            if (arg.find("--sweep=") == 0) {
+                sweep_manifest = arg.substr(std::string("--sweep=").size());
+            } else if (arg.find("--ensemble=") == 0) {
+                replicas = std::stoul(arg.substr(std::string("--ensemble=").size()));
+            } else if (arg.find("--seed=") == 0) {
+                seed = std::stoul(arg.substr(std::string("--seed=").size()));
+            } else if (arg.find("--ensemble-output=") == 0) {
+                ensemble_output = arg.substr(std::string("--ensemble-output=").size());
+            } else {
+                scenario_args.push_back(arg);
+            }
+        }
+        if (not sweep_manifest.empty()) {
+            wrench::pegasus::SweepRunner sweep_runner(sweep_manifest);
+            return sweep_runner.run(argv[0]) == 0 ? 0 : 1;
+        } else if (replicas > 0) {
+            wrench::pegasus::EnsembleRunner ensemble_runner(replicas, seed, ensemble_output, scenario_args);
+            return ensemble_runner.run(argv[0]) == 0 ? 0 : 1;
+        }
+    } catch (std::exception &e) {
+        std::cerr << "Exception: " << e.what() << std::endl;
+        return 1;
+    }
+
     // create and initialize the simulation
     wrench::Simulation simulation;
     simulation.init(&argc, argv);
 
+    // parsing options
+    std::string rescue_file;
+    std::string trace_file;
+    std::string summary_file;
+    std::string statistics_file;
+    std::string profile_file;
+    std::string perturbation_seed;
+    std::vector<char *> args;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.find("--rescue=") == 0) {
+            rescue_file = arg.substr(std::string("--rescue=").size());
+        } else if (arg.find("--trace=") == 0) {
+            trace_file = arg.substr(std::string("--trace=").size());
+        } else if (arg.find("--summary=") == 0) {
+            summary_file = arg.substr(std::string("--summary=").size());
+        } else if (arg.find("--statistics=") == 0) {
+            statistics_file = arg.substr(std::string("--statistics=").size());
+        } else if (arg.find("--profile=") == 0) {
+            profile_file = arg.substr(std::string("--profile=").size());
+        } else if (arg.find("--perturbation-seed=") == 0) {
+            perturbation_seed = arg.substr(std::string("--perturbation-seed=").size());
+        } else {
+            args.push_back(argv[i]);
+        }
+    }
+
     // check to make sure there are the right number of arguments
-    if (argc != 4) {
+    if (args.size() != 3) {
         std::cerr << "WRENCH Pegasus WMS Simulator" << std::endl;
         std::cerr << "Usage: " << argv[0]
                   << " <xml platform file> <JSON or XML workflow file> <JSON simulation config file>"
-                  << std::endl;
+                  << " [--rescue=<rescue file>] [--trace=<CSV or JSONL trace file>]"
+                  << " [--summary=<JSON summary file>] [--statistics=<JSON statistics file>]"
+                  << " [--profile=<JSON profile file>] [--perturbation-seed=<seed>]" << std::endl;
+        std::cerr << "       " << argv[0] << " <xml platform file> <JSON or XML workflow file> <JSON simulation config file>"
+                  << " --ensemble=<number of replicas> [--seed=<seed>] [--ensemble-output=<directory>]" << std::endl;
+        std::cerr << "       " << argv[0] << " --sweep=<JSON sweep manifest>" << std::endl;
         exit(1);
     }
 
     //create the platform file and dax file from command line args
-    char *platform_file = argv[1];
-    char *workflow_file = argv[2];
-    char *properties_file = argv[3];
+    char *platform_file = args[0];
+    char *workflow_file = args[1];
+    char *properties_file = args[2];
 
-    // instantiating SimGrid platform
-    WRENCH_INFO("Instantiating SimGrid platform from: %s", platform_file);
-    simulation.instantiatePlatform(platform_file);
+    // wall-clock time and peak RSS of each phase of the run
+    wrench::pegasus::PhaseProfiler profiler(not profile_file.empty());
+
+    // the profile is also written when the simulation or its output fails, with the phases measured so far
+    auto write_profile = [&profiler, &profile_file]() -> bool {
+        profiler.stop();
+        if (profile_file.empty()) {
+            return true;
+        }
+        try {
+            profiler.write(profile_file);
+        } catch (std::runtime_error &e) {
+            std::cerr << e.what() << std::endl;
+            return false;
+        }
+        return true;
+    };
 
-    // loading config file
-    WRENCH_INFO("Loading simulation config from: %s", properties_file);
+    // setup failures (platform, config, workflow files, etc.) also write the profile of the phases so far
     wrench::pegasus::SimulationConfig config;
-    config.loadProperties(simulation, properties_file);
-
-    // loading the workflow from the JSON or XML file
-    WRENCH_INFO("Loading workflow from: %s", workflow_file);
-    std::istringstream ss(workflow_file);
-    std::string token;
-    std::vector<std::string> tokens;
-    while (std::getline(ss, token, '.')) {
-        tokens.push_back(token);
-    }
+    wrench::Workflow *workflow = nullptr;
+    std::shared_ptr<wrench::pegasus::WorkflowIndex> workflow_index;
+    std::shared_ptr<wrench::pegasus::DAGMan> dagman;
+    try {
+        // instantiating SimGrid platform
+        profiler.start("platform");
+        WRENCH_INFO("Instantiating SimGrid platform from: %s", platform_file);
+        simulation.instantiatePlatform(platform_file);
 
-    if (tokens.size() < 2) {
-        std::cerr << "Invalid workflow file name " << workflow_file << " (should be *.xml or *.json)\n";
-        exit(1);
-    }
-    wrench::Workflow *workflow;
-    if (tokens[tokens.size() - 1] == "xml") {
-        workflow = wrench::PegasusWorkflowParser::createWorkflowFromDAX(workflow_file, "1f");
-    } else if (tokens[tokens.size() - 1] == "json") {
-        workflow = wrench::PegasusWorkflowParser::createWorkflowFromJSON(workflow_file, "1f");
-    } else {
-        std::cerr << "Invalid workflow file name " << workflow_file << " (should be *.xml or *.json)\n";
-        exit(1);
-    }
+        // loading config file
+        profiler.start("config");
+        WRENCH_INFO("Loading simulation config from: %s", properties_file);
+        config.loadProperties(simulation, properties_file);
 
-    WRENCH_INFO("The workflow has %ld tasks", workflow->getNumberOfTasks());
+        // loading the workflow from the JSON or XML file
+        profiler.start("workflow");
+        WRENCH_INFO("Loading workflow from: %s", workflow_file);
+        std::istringstream ss(workflow_file);
+        std::string token;
+        std::vector<std::string> tokens;
+        while (std::getline(ss, token, '.')) {
+            tokens.push_back(token);
+        }
 
-    // create the HTCondor services
-    std::shared_ptr<wrench::HTCondorComputeService> htcondor_service = config.getHTCondorService();
+        if (tokens.size() < 2) {
+            std::cerr << "Invalid workflow file name " << workflow_file << " (should be *.xml or *.json)\n";
+            write_profile();
+            return 1;
+        }
+        // task transformations (DAX job names), which are the task categories
+        wrench::pegasus::TaskCategoryRegistry::TransformationMap transformations;
+        std::string cache_file = wrench::pegasus::WorkflowCache::getCacheFilename(workflow_file);
+        if (wrench::pegasus::WorkflowCache::isValid(cache_file, workflow_file)) {
+            WRENCH_INFO("Loading pre-parsed workflow from: %s", cache_file.c_str());
+            workflow = wrench::pegasus::WorkflowCache::load(cache_file, &transformations);
+        } else if (tokens[tokens.size() - 1] == "xml") {
+            workflow = wrench::PegasusWorkflowParser::createWorkflowFromDAX(workflow_file, "1f");
+            transformations = wrench::pegasus::TaskCategoryRegistry::readTransformations(workflow_file);
+        } else if (tokens[tokens.size() - 1] == "json") {
+            workflow = wrench::PegasusWorkflowParser::createWorkflowFromJSON(workflow_file, "1f");
+        } else {
+            std::cerr << "Invalid workflow file name " << workflow_file << " (should be *.xml or *.json)\n";
+            write_profile();
+            return 1;
+        }
 
-    // file registry service
-    WRENCH_INFO("Instantiating a FileRegistryService on: %s", config.getFileRegistryHostname().c_str());
-    std::shared_ptr<wrench::FileRegistryService> file_registry_service = simulation.add(
-            new wrench::FileRegistryService(config.getFileRegistryHostname()));
+        WRENCH_INFO("The workflow has %ld tasks", workflow->getNumberOfTasks());
 
-    // create the DAGMan wms
-    auto dagman = simulation.add(new wrench::pegasus::DAGMan(config.getSubmitHostname(),
-                                                             {htcondor_service},
-                                                             config.getStorageServices(),
-                                                             file_registry_service,
-                                                             config.getEnergyScheme()));
-    dagman->addWorkflow(workflow);
-    dagman->setExecutionHosts(config.getExecutionHosts());
+        // ensemble replica: task flops and file sizes are perturbed according to the simulation config
+        auto runtime_perturbation = config.getRuntimePerturbation();
+        if (not perturbation_seed.empty() && not runtime_perturbation.isEmpty()) {
+            WRENCH_INFO("Perturbing task flops and file sizes with seed %s", perturbation_seed.c_str());
+            auto perturbed_workflow = runtime_perturbation.apply(workflow, std::stoul(perturbation_seed),
+                                                                 transformations);
+            delete workflow;
+            workflow = perturbed_workflow;
+        }
 
-    // stage input data
-    WRENCH_INFO("Staging workflow input files to external Storage Service...");
-    std::map<std::string, std::shared_ptr<wrench::StorageService>> storage_services = config.getStorageServicesMap();
+        // resuming from a rescue file: tasks completed in a previous run are not simulated again (completed tasks
+        // are only recorded when a rescue file is set)
+        std::shared_ptr<wrench::pegasus::RescueDAG> rescue_dag;
+        std::map<wrench::WorkflowFile *, std::string> rescued_files;
+        if (not rescue_file.empty()) {
+            rescue_dag = std::make_shared<wrench::pegasus::RescueDAG>();
+        }
+        if (not rescue_file.empty() && std::ifstream(rescue_file).good()) {
+            WRENCH_INFO("Loading rescue file: %s", rescue_file.c_str());
+            rescue_dag->load(rescue_file);
+            rescued_files = rescue_dag->apply(workflow);
+            WRENCH_INFO("Resuming with %ld completed tasks, %ld tasks left", rescue_dag->getNumberOfCompletedTasks(),
+                        workflow->getNumberOfTasks());
+        }
 
-    for (auto file : workflow->getInputFiles()) {
-        for (auto storage_service : storage_services) {
-            simulation.stageFile(file, storage_service.second);
+        // indexing the workflow DAG
+        profiler.start("setup");
+        workflow_index = std::make_shared<wrench::pegasus::WorkflowIndex>(workflow, transformations);
+
+        // category limits must name a task category or type (sub-workflows may add categories when expanded)
+        auto unknown_categories = config.getDAGManThrottle().getUnknownCategories(workflow_index->getCategories());
+        for (auto &category : unknown_categories) {
+            std::cerr << (config.getSubWorkflows().empty() ? "Error" : "Warning") << ": category_maxjobs key "
+                      << category << " matches no task category or type of the workflow" << std::endl;
+        }
+        if (not unknown_categories.empty() && config.getSubWorkflows().empty()) {
+            write_profile();
+            return 1;
+        }
+
+        // create the HTCondor services
+        auto htcondor_services = config.getHTCondorServices();
+
+        // file registry service
+        WRENCH_INFO("Instantiating a FileRegistryService on: %s", config.getFileRegistryHostname().c_str());
+        std::shared_ptr<wrench::FileRegistryService> file_registry_service = simulation.add(
+                new wrench::FileRegistryService(config.getFileRegistryHostname()));
+
+        // create the DAGMan wms
+        dagman = simulation.add(new wrench::pegasus::DAGMan(config.getSubmitHostname(),
+                                                                 htcondor_services,
+                                                                 config.getStorageServices(),
+                                                                 file_registry_service,
+                                                                 config.getEnergyScheme()));
+        dagman->addWorkflow(workflow);
+        dagman->setWorkflowIndex(workflow_index);
+        dagman->setExecutionHosts(config.getExecutionHosts());
+        dagman->setEventDriven(config.isDAGManEventDriven(), config.getDAGManCoalesceWindow());
+        dagman->setThrottle(config.getDAGManThrottle());
+        dagman->setPoolSlots(config.getHTCondorSlots());
+        dagman->setLocalityAwarePlacement(config.isLocalityAwarePlacement());
+        if (rescue_dag) {
+            dagman->setRescueDAG(rescue_dag, rescue_file);
+        }
+        dagman->setExactEnergy(config.isExactEnergy());
+        if (not trace_file.empty()) {
+            WRENCH_INFO("Streaming task records to: %s", trace_file.c_str());
+            dagman->setTraceSink(std::make_shared<wrench::pegasus::TaskTraceSink>(trace_file, workflow_index));
+        }
+        dagman->setAsynchronousStageIn(config.isAsynchronousStageIn(), config.getMaxConcurrentTransfers());
+        dagman->setJobClustering(std::make_shared<wrench::pegasus::JobClustering>(*workflow_index,
+                                                                                  config.getClusteringSettings()));
+        auto sub_workflows = config.getSubWorkflows();
+        if (not sub_workflows.empty()) {
+            dagman->setSubWorkflowExpander(std::make_shared<wrench::pegasus::SubWorkflowExpander>(sub_workflows));
         }
+
+        // stage input data
+        profiler.start("staging");
+        WRENCH_INFO("Staging workflow input files to external Storage Service...");
+        std::map<std::string, std::shared_ptr<wrench::StorageService>> storage_services =
+                config.getStorageServicesMap();
+
+        config.getInputPlacement().stage(simulation, workflow->getInputFiles(), storage_services);
+
+        // output files of tasks completed in a previous run are also available where they were produced
+        for (auto &rescued_file : rescued_files) {
+            for (auto &htcondor_service : htcondor_services) {
+                auto local_storage_service = htcondor_service->getLocalStorageService();
+                if (local_storage_service->getHostname() == rescued_file.second) {
+                    simulation.stageFile(rescued_file.first, local_storage_service);
+                }
+            }
+        }
+    } catch (std::exception &e) {
+        std::cerr << "Exception: " << e.what() << std::endl;
+        write_profile();
+        return 1;
     }
 
     // simulation execution
+    profiler.start("simulation");
     WRENCH_INFO("Launching the Simulation...");
     try {
         simulation.launch();
     } catch (std::runtime_error &e) {
         std::cerr << "Exception: " << e.what() << std::endl;
-        return 0;
-    }WRENCH_INFO("Simulation done!");
+        write_profile();
+        return 1;
+    }
+    WRENCH_INFO("Simulation done!");
 
     // statistics
-    std::map<std::string, double> start_stats;
-    std::map<std::string, double> completion_stats;
-    std::map<std::string, double> scheduled_stats;
-    std::map<std::string, double> duration_stats;
-    std::map<std::string, unsigned long> level_stats;
-
-    auto submit_trace = simulation.getOutput().getTrace<wrench::pegasus::SimulationTimestampJobSubmitted>();
-    for (auto &task : submit_trace) {
-        auto t = task->getContent();
-        start_stats.insert(std::make_pair(t->getTask()->getID(), t->getClock()));
-    }
+    profiler.start("summary");
+    auto &categories = workflow_index->getCategories();
+
+    // without a trace file, the task execution summary is printed at the end of the run (tasks of sub-workflows
+    // are released once completed, and only appear in traces)
+    if (trace_file.empty()) {
+        auto lifecycle_table = dagman->getTaskLifecycleTable();
 
-    auto scheduled_trace = simulation.getOutput().getTrace<wrench::pegasus::SimulationTimestampJobScheduled>();
-    for (auto &task : scheduled_trace) {
-        auto t = task->getContent();
-        scheduled_stats.insert(std::make_pair(t->getTask()->getID(), t->getClock()));
+        std::cerr << "=== WRENCH-Pegasus: Task Execution Summary" << std::endl;
+        for (unsigned long id = 0; id < lifecycle_table->getNumberOfTasks(); id++) {
+            if (not lifecycle_table->isCompleted(id) || not workflow_index->getTask(id)) {
+                continue;
+            }
+            double submitted_time = lifecycle_table->getSubmittedDate(id);
+            double completion_time = lifecycle_table->getCompletionDate(id);
+            double duration = completion_time - lifecycle_table->getScheduledDate(id);
+
+            std::cerr << "wrench," <<
+                      workflow_index->getTask(id)->getID() << "," <<
+                      submitted_time << "," <<
+                      completion_time << "," <<
+                      completion_time - submitted_time << "," <<
+                      duration << "," <<
+                      workflow_index->getTopLevel(id) << "," <<
+                      categories.getCategoryName(categories.getTaskCategory(id)) << "\n";
+        }
     }
 
-    auto completion_trace = simulation.getOutput().getTrace<wrench::pegasus::SimulationTimestampJobCompletion>();
-    for (auto &task : completion_trace) {
-        auto t = task->getContent();
-        duration_stats.insert(
-                std::make_pair(t->getTask()->getID(), t->getTask()->getEndDate() - t->getTask()->getStartDate()));
-        completion_stats.insert(std::make_pair(t->getTask()->getID(), t->getClock()));
-        level_stats.insert(std::make_pair(t->getTask()->getID(), t->getTask()->getTopLevel()));
+    // run summary (makespan, energy, number of task categories, and task durations per category), e.g., for
+    // ensemble replicas
+    if (not summary_file.empty()) {
+        auto lifecycle_table = dagman->getTaskLifecycleTable();
+        double makespan = 0;
+        std::map<std::string, std::vector<double>> task_durations;
+        for (unsigned long id = 0; id < lifecycle_table->getNumberOfTasks(); id++) {
+            auto task = workflow_index->getTask(id);
+            if (lifecycle_table->isCompleted(id) && task) {
+                makespan = std::max(makespan, lifecycle_table->getCompletionDate(id));
+                task_durations[categories.getCategoryName(categories.getTaskCategory(id))].push_back(
+                        task->getEndDate() - task->getStartDate());
+            }
+        }
+        nlohmann::json summary = {{"makespan",       makespan},
+                                  {"completed",      workflow->isDone()},
+                                  {"events",         dagman->getNumberOfProcessedEvents()},
+                                  {"categories",     categories.getNumberOfCategories()},
+                                  {"task_durations", task_durations}};
+        if (dagman->getPowerMeter()) {
+            double energy = 0;
+            for (auto &hostname : config.getExecutionHosts()) {
+                energy += dagman->getPowerMeter()->getEnergyConsumed(hostname);
+            }
+            summary["energy"] = energy;
+        }
+        std::ofstream file(summary_file);
+        if (not file) {
+            std::cerr << "Unable to write summary file " << summary_file << std::endl;
+            write_profile();
+            return 1;
+        }
+        file << summary.dump() << "\n";
     }
 
-    std::cerr << "=== WRENCH-Pegasus: Task Execution Summary" << std::endl;
-    for (const auto &task : start_stats) {
-        auto completion_time = (*completion_stats.find(task.first)).second;
-        double duration = completion_time - (*scheduled_stats.find(task.first)).second;
-        unsigned long level = (*level_stats.find(task.first)).second;
-
-        std::string task_name = task.first.substr(0, task.first.find("_"));
-        if (task_name == "clean") {
-            task_name = "clean_up";
-        } else if (task_name == "stage") {
-            task_name = task.first.substr(0, task.first.find("_", task.first.find("_") + 1));
-        } else if (task_name == "create") {
-            task_name = "create_dir";
-        }
-
-        std::cerr << "wrench," <<
-                  task.first << "," <<
-                  task.second << "," <<
-                  completion_time << "," <<
-                  completion_time - task.second << "," <<
-                  duration << "," <<
-                  level << "," <<
-                  task_name <<
-                  std::endl;
+    // counters of the DAGMan scheduling loop, scheduler, and monitor
+    if (not statistics_file.empty() && dagman->getStatistics()) {
+        try {
+            dagman->getStatistics()->write(statistics_file);
+        } catch (std::runtime_error &e) {
+            std::cerr << e.what() << std::endl;
+            write_profile();
+            return 1;
+        }
     }
 
     if (not config.getEnergyScheme().empty()) {
         std::cerr << "=== WRENCH-Pegasus: Energy Profile Summary" << std::endl;
         auto power_trace = simulation.getOutput().getTrace<wrench::SimulationTimestampEnergyConsumption>();
         std::map<std::string, std::pair<double, unsigned long>> average_task_power;
+
+        // exact integration: time-weighted average power over the intervals at full load
+        std::map<std::string, std::pair<double, double>> energy_per_label;
+        for (auto interval : simulation.getOutput().getTrace<wrench::pegasus::SimulationTimestampHostPower>()) {
+            auto content = interval->getContent();
+            if (content->isFullLoad()) {
+                energy_per_label[content->getLabel()].first += content->getEnergy();
+                energy_per_label[content->getLabel()].second += content->getEndDate() - content->getStartDate();
+            }
+        }
+        for (auto &label : energy_per_label) {
+            average_task_power[label.first] = std::make_pair(label.second.first / label.second.second, 1);
+        }
+
         for (auto measurement : power_trace) {
             if (average_task_power.find(measurement->getContent()->getHostname()) == average_task_power.end()) {
                 average_task_power.insert(std::make_pair(measurement->getContent()->getHostname(),
@@ -176,15 +397,55 @@ int main(int argc, char **argv) {
             }
         }
 
+        // number of cores of the (homogeneous) execution hosts
+        unsigned long num_cores = config.getExecutionHosts().empty() ? 0 : wrench::S4U_Simulation::getHostNumCores(
+                config.getExecutionHosts().front());
         for (auto it : average_task_power) {
-            std::cerr << wrench::S4U_Simulation::getHostNumCores("taurus-worker.lyon.grid5000.fr") << "," <<
+            std::cerr << num_cores << "," <<
                       config.getEnergyScheme() << "," <<
                       it.first << "," <<
                       it.second.first / it.second.second << "," <<
                       "wrench-pegasus" <<
                       std::endl;
         }
+
+        // energy attributed to each task (its share of the dynamic power of its host), category, and host
+        auto power_meter = dagman->getPowerMeter();
+        std::cerr << "=== WRENCH-Pegasus: Energy Attribution Summary" << std::endl;
+        std::vector<double> category_energy(categories.getNumberOfCategories(), 0);
+        for (unsigned long id = 0; id < workflow_index->getNumberOfTasks(); id++) {
+            auto task = workflow_index->getTask(id);
+            double energy = power_meter->getTaskEnergyConsumed(id);
+            category_energy[categories.getTaskCategory(id)] += energy;
+            if (not task) {
+                continue;
+            }
+            std::cerr << "task," <<
+                      task->getID() << "," <<
+                      categories.getCategoryName(categories.getTaskCategory(id)) << "," <<
+                      task->getExecutionHost() << "," <<
+                      energy <<
+                      std::endl;
+        }
+        for (unsigned int category = 0; category < categories.getNumberOfCategories(); category++) {
+            std::cerr << "category," <<
+                      categories.getCategoryName(category) << "," <<
+                      category_energy[category] <<
+                      std::endl;
+        }
+        for (auto &hostname : config.getExecutionHosts()) {
+            std::cerr << "host," <<
+                      hostname << "," <<
+                      power_meter->getEnergyConsumed(hostname) << "," <<
+                      power_meter->getDynamicEnergyConsumed(hostname) <<
+                      std::endl;
+        }
+    }
+
+    if (not write_profile()) {
+        return 1;
     }
 
-    return 0;
+    // the workflow execution is aborted on failure, which fails the scenario in a sweep
+    return workflow->isDone() ? 0 : 1;
 }
@@ -13,81 +13,75 @@ namespace wrench {
     namespace pegasus {
 
         /**
-         * @brief
+         * @brief Constructor
          *
-         * @param task
+         * @param hostname: the host name
+         * @param label: the type of the most recently started task running on the host (empty if idle)
+         * @param start_date: the start date of the interval
+         * @param end_date: the end date of the interval
+         * @param power: the power of the host over the interval, in Watts
+         * @param full_load: whether all cores of the host were running tasks over the interval
          */
-        SimulationTimestampJobSubmitted::SimulationTimestampJobSubmitted(WorkflowTask *task)
-                : clock(S4U_Simulation::getClock()), task(task) {}
+        SimulationTimestampHostPower::SimulationTimestampHostPower(const std::string &hostname,
+                                                                   const std::string &label, double start_date,
+                                                                   double end_date, double power, bool full_load)
+                : hostname(hostname), label(label), start_date(start_date), end_date(end_date), power(power),
+                  full_load(full_load) {}
 
         /**
-         * @brief
-         *
-         * @return
+         * @brief Get the host name
+         * @return the host name
          */
-        WorkflowTask *SimulationTimestampJobSubmitted::getTask() {
-          return this->task;
+        std::string SimulationTimestampHostPower::getHostname() {
+            return this->hostname;
         }
 
         /**
-         * @brief
-         *
-         * @return
+         * @brief Get the type of the most recently started task running on the host
+         * @return the task type (empty if the host was idle)
          */
-        double SimulationTimestampJobSubmitted::getClock() {
-          return this->clock;
+        std::string SimulationTimestampHostPower::getLabel() {
+            return this->label;
         }
 
         /**
-         * @brief
-         *
-         * @param task
-         */
-        SimulationTimestampJobScheduled::SimulationTimestampJobScheduled(WorkflowTask *task)
-                : clock(S4U_Simulation::getClock()), task(task) {}
-
-        /**
-         * @brief
-         *
-         * @return
+         * @brief Get the start date of the interval
+         * @return the start date
          */
-        WorkflowTask *SimulationTimestampJobScheduled::getTask() {
-          return this->task;
+        double SimulationTimestampHostPower::getStartDate() {
+            return this->start_date;
         }
 
         /**
-         * @brief
-         *
-         * @return
+         * @brief Get the end date of the interval
+         * @return the end date
          */
-        double SimulationTimestampJobScheduled::getClock() {
-          return this->clock;
+        double SimulationTimestampHostPower::getEndDate() {
+            return this->end_date;
         }
 
         /**
-         * @brief
-         *
-         * @param task
+         * @brief Get the power of the host over the interval
+         * @return the power in Watts
          */
-        SimulationTimestampJobCompletion::SimulationTimestampJobCompletion(WorkflowTask *task)
-                : clock(S4U_Simulation::getClock()), task(task) {}
+        double SimulationTimestampHostPower::getPower() {
+            return this->power;
+        }
 
         /**
-         * @brief
-         *
-         * @return
+         * @brief Get the energy consumed by the host over the interval
+         * @return the energy in Joules
          */
-        WorkflowTask *SimulationTimestampJobCompletion::getTask() {
-          return this->task;
+        double SimulationTimestampHostPower::getEnergy() {
+            return this->power * (this->end_date - this->start_date);
         }
 
         /**
-         * @brief
-         *
-         * @return
+         * @brief Get whether all cores of the host were running tasks over the interval
+         * @return true if the host was fully loaded
          */
-        double SimulationTimestampJobCompletion::getClock() {
-          return this->clock;
+        bool SimulationTimestampHostPower::isFullLoad() {
+            return this->full_load;
         }
     }
 }
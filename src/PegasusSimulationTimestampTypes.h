@@ -13,48 +13,37 @@
 #include <wrench-dev.h>
 
 namespace wrench {
-
-    class WorkflowTask;
-
     namespace pegasus {
 
-        class SimulationTimestampJobSubmitted {
+        /**
+         * @brief Power of a host over an interval during which its set of running tasks did not change
+         */
+        class SimulationTimestampHostPower {
         public:
-            SimulationTimestampJobSubmitted(WorkflowTask *task);
-
-            WorkflowTask *getTask();
+            SimulationTimestampHostPower(const std::string &hostname, const std::string &label, double start_date,
+                                         double end_date, double power, bool full_load);
 
-            double getClock();
+            std::string getHostname();
 
-        private:
-            double clock;
-            WorkflowTask *task;
-        };
+            std::string getLabel();
 
-        class SimulationTimestampJobScheduled {
-        public:
-            SimulationTimestampJobScheduled(WorkflowTask *task);
+            double getStartDate();
 
-            WorkflowTask *getTask();
+            double getEndDate();
 
-            double getClock();
-
-        private:
-            double clock;
-            WorkflowTask *task;
-        };
-
-        class SimulationTimestampJobCompletion {
-        public:
-            SimulationTimestampJobCompletion(WorkflowTask *task);
+            double getPower();
 
-            WorkflowTask *getTask();
+            double getEnergy();
 
-            double getClock();
+            bool isFullLoad();
 
         private:
-            double clock;
-            WorkflowTask *task;
+            std::string hostname;
+            std::string label;
+            double start_date;
+            double end_date;
+            double power;
+            bool full_load;
         };
     }
 }
@@ -0,0 +1,103 @@
+/**
+ * Copyright (c) 2017-2021. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <fstream>
+#include <stdexcept>
+#include <sys/resource.h>
+#include <nlohmann/json.hpp>
+
+#include "PhaseProfiler.h"
+
+namespace wrench {
+    namespace pegasus {
+
+        /**
+         * @brief Constructor
+         *
+         * @param enabled: whether phases are measured
+         */
+        PhaseProfiler::PhaseProfiler(bool enabled) : enabled(enabled) {}
+
+        /**
+         * @brief Start a phase, ending the current phase (if any)
+         *
+         * @param phase: the name of the phase
+         */
+        void PhaseProfiler::start(const std::string &phase) {
+            if (not this->enabled) {
+                return;
+            }
+            this->stop();
+            this->current_phase = phase;
+            this->current_peak_rss = getPeakRSS();
+            this->current_start = std::chrono::steady_clock::now();
+        }
+
+        /**
+         * @brief End the current phase (if any)
+         */
+        void PhaseProfiler::stop() {
+            if (not this->enabled || this->current_phase.empty()) {
+                return;
+            }
+            Phase phase;
+            phase.name = this->current_phase;
+            phase.wall_time = std::chrono::duration<double>(
+                    std::chrono::steady_clock::now() - this->current_start).count();
+            phase.peak_rss = getPeakRSS();
+            phase.peak_rss_delta = phase.peak_rss - this->current_peak_rss;
+            this->phases.push_back(phase);
+            this->current_phase.clear();
+        }
+
+        /**
+         * @brief Write the completed phases to a JSON file
+         *
+         * @param filename: the name of the file
+         *
+         * @throw std::runtime_error
+         */
+        void PhaseProfiler::write(const std::string &filename) const {
+            nlohmann::json json_phases = nlohmann::json::array();
+            double total_wall_time = 0;
+            for (auto &phase : this->phases) {
+                json_phases.push_back({{"phase",          phase.name},
+                                       {"wall_time",      phase.wall_time},
+                                       {"peak_rss_delta", phase.peak_rss_delta},
+                                       {"peak_rss",       phase.peak_rss}});
+                total_wall_time += phase.wall_time;
+            }
+
+            std::ofstream file(filename);
+            if (not file) {
+                throw std::runtime_error("PhaseProfiler::write(): Unable to write profile file " + filename);
+            }
+            file << nlohmann::json({{"phases",    json_phases},
+                                    {"wall_time", total_wall_time},
+                                    {"peak_rss",  getPeakRSS()}}).dump(2) << "\n";
+        }
+
+        /**
+         * @brief Get the peak resident set size of the process
+         * @return the peak RSS in KB
+         */
+        unsigned long PhaseProfiler::getPeakRSS() {
+            struct rusage usage;
+            if (getrusage(RUSAGE_SELF, &usage) != 0) {
+                return 0;
+            }
+#ifdef __APPLE__
+            // reported in bytes on macOS
+            return usage.ru_maxrss / 1024;
+#else
+            return usage.ru_maxrss;
+#endif
+        }
+    }
+}
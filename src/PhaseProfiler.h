@@ -0,0 +1,66 @@
+/**
+ * Copyright (c) 2017-2021. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef PEGASUS_PHASEPROFILER_H
+#define PEGASUS_PHASEPROFILER_H
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace wrench {
+    namespace pegasus {
+
+        /**
+         * @brief Wall-clock time and peak resident set size (RSS) profiling of the consecutive phases of a
+         *        simulator run (platform instantiation, workflow parsing, staging, simulation, etc.). A disabled
+         *        profiler does not measure anything.
+         */
+        class PhaseProfiler {
+        public:
+            explicit PhaseProfiler(bool enabled);
+
+            void start(const std::string &phase);
+
+            void stop();
+
+            void write(const std::string &filename) const;
+
+        private:
+            static unsigned long getPeakRSS();
+
+            /**
+             * @brief A completed phase
+             */
+            struct Phase {
+                /** @brief The name of the phase */
+                std::string name;
+                /** @brief Wall-clock time of the phase, in seconds */
+                double wall_time;
+                /** @brief Increase of the peak RSS of the process during the phase, in KB */
+                unsigned long peak_rss_delta;
+                /** @brief Peak RSS of the process at the end of the phase, in KB */
+                unsigned long peak_rss;
+            };
+
+            /** @brief Whether phases are measured */
+            bool enabled;
+            /** @brief Completed phases, in order */
+            std::vector<Phase> phases;
+            /** @brief Name of the current phase (empty if none) */
+            std::string current_phase;
+            /** @brief Wall-clock time at the start of the current phase */
+            std::chrono::steady_clock::time_point current_start;
+            /** @brief Peak RSS at the start of the current phase, in KB */
+            unsigned long current_peak_rss = 0;
+        };
+    }
+}
+
+#endif //PEGASUS_PHASEPROFILER_H
@@ -7,7 +7,11 @@
  * (at your option) any later version.
  */
 
+#include <algorithm>
+#include <tuple>
+
 #include "PowerMeter.h"
+#include "PegasusSimulationTimestampTypes.h"
 #include "wrench/simgrid_S4U_util/S4U_Simulation.h"
 
 #define EPSILON 0.0001
@@ -24,10 +28,14 @@ namespace wrench {
          * @param hostnames: the list of metered hosts, as hostnames
          * @param measurement_period: the measurement period
          * @param pairwise: whether cores in socket are enabled in pairwise manner
+         * @param workflow_index: the index of the workflow (used to label measurements by task type)
+         * @param exact: whether energy is integrated exactly each time the set of running tasks of a host changes
+         *               (see update()), instead of sampling power every measurement period
          */
         PowerMeter::PowerMeter(WMS *wms, const std::vector<std::string> &hostnames, double measurement_period,
-                               bool pairwise) :
-                Service(wms->hostname, "power_meter", "power_meter"), pairwise(pairwise) {
+                               bool pairwise, std::shared_ptr<WorkflowIndex> workflow_index, bool exact) :
+                Service(wms->hostname, "power_meter", "power_meter"), pairwise(pairwise),
+                workflow_index(workflow_index), exact(exact) {
             if (hostnames.empty()) {
                 throw std::invalid_argument("PowerMeter::PowerMeter(): no host to meter!");
             }
@@ -36,6 +44,10 @@ namespace wrench {
             }
 
             this->wms = wms;
+            if (not this->workflow_index) {
+                this->workflow_index = std::make_shared<WorkflowIndex>(wms->getWorkflow());
+            }
+            this->task_energy.assign(this->workflow_index->getNumberOfTasks(), 0);
 
             for (auto const &h : hostnames) {
                 if (not S4U_Simulation::hostExists(h)) {
@@ -43,19 +55,267 @@ namespace wrench {
                 }
                 this->measurement_periods[h] = measurement_period;
                 this->time_to_next_measurement[h] = 0.0;  // We begin by taking a measurement
+                HostEnergy energy;
+                energy.idle = 0;
+                energy.dynamic = 0;
+                this->host_energy[h] = energy;
+                if (this->exact) {
+                    HostPower power;
+                    power.last_change = Simulation::getCurrentSimulatedDate();
+                    power.power = S4U_Simulation::getMinPowerConsumption(h);
+                    this->host_power[h] = power;
+                }
             }
         }
 
         /**
-         * @brief Compare the start time between two workflow tasks
+         * @brief Compare the start time between two workflow tasks (tasks started at the same time are
+         *        ordered by ID)
          *
          * @param lhs: pointer to a workflow task
          * @param rhs: pointer to a workflow task
          *
          * @return whether the start time of the left-hand-side workflow tasks is earlier
          */
-        bool PowerMeter::TaskStartTimeComparator::operator()(WorkflowTask *&lhs, WorkflowTask *&rhs) {
-            return lhs->getStartDate() < rhs->getStartDate();
+        bool PowerMeter::TaskStartTimeComparator::operator()(WorkflowTask *lhs, WorkflowTask *rhs) const {
+            if (lhs->getStartDate() != rhs->getStartDate()) {
+                return lhs->getStartDate() < rhs->getStartDate();
+            }
+            return lhs->getID() < rhs->getID();
+        }
+
+        /**
+         * @brief Notify the power meter that tasks have been submitted. They are indexed by execution host
+         *        once they start running.
+         *
+         * @param tasks: the submitted tasks
+         */
+        void PowerMeter::notifyTasksSubmitted(const std::vector<WorkflowTask *> &tasks) {
+            this->submitted_tasks.insert(tasks.begin(), tasks.end());
+        }
+
+        /**
+         * @brief Notify the power meter that a task has completed (in exact mode, task ends are processed by
+         *        update() based on the task end dates)
+         *
+         * @param task: the completed task
+         */
+        void PowerMeter::notifyTaskCompleted(WorkflowTask *task) {
+            if (this->exact || this->submitted_tasks.erase(task) > 0) {
+                return;
+            }
+            auto it = this->running_tasks.find(task->getExecutionHost());
+            if (it != this->running_tasks.end()) {
+                it->second.erase(task);
+            }
+        }
+
+        /**
+         * @brief Move the submitted tasks that have started into the index of running tasks per host, and
+         *        remove the tasks that have ended (and whose completion has not been notified yet)
+         */
+        void PowerMeter::updateRunningTasks() {
+            for (auto it = this->submitted_tasks.begin(); it != this->submitted_tasks.end();) {
+                auto task = *it;
+                if (task->getStartDate() != -1) {
+                    if (task->getEndDate() == -1) {
+                        this->running_tasks[task->getExecutionHost()].insert(task);
+                    }
+                    it = this->submitted_tasks.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+
+        /**
+         * @brief Integrate energy exactly up to the current date (exact mode). Power is piecewise-constant
+         *        between task starts and ends, whose dates are all known by now: for each host, the intervals
+         *        between consecutive changes of its running set are integrated and recorded.
+         */
+        void PowerMeter::update() {
+            if (not this->exact) {
+                return;
+            }
+
+            // changes of the running sets, as (date, is start, task), with ends before starts at the same date
+            std::vector<std::tuple<double, bool, WorkflowTask *>> changes;
+            for (auto it = this->submitted_tasks.begin(); it != this->submitted_tasks.end();) {
+                auto task = *it;
+                if (task->getStartDate() != -1) {
+                    changes.push_back(std::make_tuple(task->getStartDate(), true, task));
+                    if (task->getEndDate() != -1) {
+                        changes.push_back(std::make_tuple(task->getEndDate(), false, task));
+                    }
+                    it = this->submitted_tasks.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+            for (auto &host_tasks : this->running_tasks) {
+                for (auto task : host_tasks.second) {
+                    if (task->getEndDate() != -1) {
+                        changes.push_back(std::make_tuple(task->getEndDate(), false, task));
+                    }
+                }
+            }
+            std::sort(changes.begin(), changes.end(),
+                      [](const std::tuple<double, bool, WorkflowTask *> &lhs,
+                         const std::tuple<double, bool, WorkflowTask *> &rhs) {
+                          if (std::get<0>(lhs) != std::get<0>(rhs)) {
+                              return std::get<0>(lhs) < std::get<0>(rhs);
+                          }
+                          return std::get<1>(lhs) < std::get<1>(rhs);
+                      });
+
+            for (auto &change : changes) {
+                auto task = std::get<2>(change);
+                std::string hostname = task->getExecutionHost();
+                this->integrate(hostname, std::get<0>(change));
+                auto &tasks = this->running_tasks[hostname];
+                if (std::get<1>(change)) {
+                    tasks.insert(task);
+                } else {
+                    tasks.erase(task);
+                }
+
+                // power until the next change
+                auto it = this->host_power.find(hostname);
+                if (it != this->host_power.end()) {
+                    it->second.task_powers.clear();
+                    it->second.power = this->computePowerMeasurements(hostname, tasks, false,
+                                                                      &it->second.task_powers);
+                }
+            }
+        }
+
+        /**
+         * @brief Integrate energy exactly up to the current date (exact mode), including the interval since the
+         *        last change of the running set of each host, e.g., idle power after the last task ended
+         */
+        void PowerMeter::finish() {
+            if (not this->exact) {
+                return;
+            }
+            this->update();
+            double date = S4U_Simulation::getClock();
+            for (auto &power : this->host_power) {
+                this->integrate(power.first, date);
+            }
+        }
+
+        /**
+         * @brief Close the current interval of a host at a given date (exact mode): the energy consumed over the
+         *        interval is attributed to the host and its running tasks, and the interval is recorded
+         *
+         * @param hostname: the host name
+         * @param date: the date of the change of the host running set
+         */
+        void PowerMeter::integrate(const std::string &hostname, double date) {
+            auto it = this->host_power.find(hostname);
+            if (it == this->host_power.end()) {
+                // host not metered
+                return;
+            }
+            auto &power = it->second;
+            if (date > power.last_change) {
+                auto &tasks = this->running_tasks[hostname];
+                this->attributeEnergy(hostname, tasks, power.task_powers, date - power.last_change);
+                this->simulation->getOutput().addTimestamp<SimulationTimestampHostPower>(
+                        new SimulationTimestampHostPower(hostname, this->getLabel(tasks), power.last_change, date,
+                                                         power.power,
+                                                         tasks.size() == S4U_Simulation::getHostNumCores(hostname)));
+                power.last_change = date;
+            }
+        }
+
+        /**
+         * @brief Attribute the energy consumed by a host over a time span: idle power is attributed to the host,
+         *        and the dynamic power of each running task (according to the core model) to the task
+         *
+         * @param hostname: the host name
+         * @param tasks: the tasks running on the host, ordered by start time
+         * @param task_powers: the dynamic power of each running task, in the same order
+         * @param duration: the time span, in seconds
+         */
+        void PowerMeter::attributeEnergy(const std::string &hostname,
+                                         const std::set<WorkflowTask *, TaskStartTimeComparator> &tasks,
+                                         const std::vector<double> &task_powers, double duration) {
+            auto &energy = this->host_energy[hostname];
+            energy.idle += S4U_Simulation::getMinPowerConsumption(hostname) * duration;
+
+            auto task_power = task_powers.begin();
+            for (auto task : tasks) {
+                if (task_power == task_powers.end()) {
+                    break;
+                }
+                energy.dynamic += *task_power * duration;
+                unsigned long id = this->workflow_index->getTaskIndex(task);
+                if (id >= this->task_energy.size()) {
+                    // tasks of an expanded sub-workflow
+                    this->task_energy.resize(this->workflow_index->getNumberOfTasks(), 0);
+                }
+                this->task_energy[id] += *task_power * duration;
+                ++task_power;
+            }
+        }
+
+        /**
+         * @brief Get the energy consumed by a host (in exact mode, up to the last update, or the end of the
+         *        execution once finished)
+         *
+         * @param hostname: the host name
+         * @return the energy consumed in Joules
+         *
+         * @throw std::invalid_argument
+         */
+        double PowerMeter::getEnergyConsumed(const std::string &hostname) {
+            auto it = this->host_energy.find(hostname);
+            if (it == this->host_energy.end()) {
+                throw std::invalid_argument("PowerMeter::getEnergyConsumed(): host " + hostname + " is not metered");
+            }
+            return it->second.idle + it->second.dynamic;
+        }
+
+        /**
+         * @brief Get the energy consumed by a host related to the tasks it ran (i.e., excluding idle power)
+         *
+         * @param hostname: the host name
+         * @return the dynamic energy consumed in Joules
+         *
+         * @throw std::invalid_argument
+         */
+        double PowerMeter::getDynamicEnergyConsumed(const std::string &hostname) {
+            auto it = this->host_energy.find(hostname);
+            if (it == this->host_energy.end()) {
+                throw std::invalid_argument(
+                        "PowerMeter::getDynamicEnergyConsumed(): host " + hostname + " is not metered");
+            }
+            return it->second.dynamic;
+        }
+
+        /**
+         * @brief Get the energy attributed to a task: its share of the dynamic power of the host it ran on
+         *
+         * @param id: the task dense ID
+         * @return the energy attributed to the task in Joules
+         */
+        double PowerMeter::getTaskEnergyConsumed(unsigned long id) {
+            return id < this->task_energy.size() ? this->task_energy[id] : 0;
+        }
+
+        /**
+         * @brief Get the label of power measurements: the type of the most recently started running task
+         *
+         * @param tasks: the tasks running on a host, ordered by start time
+         * @return the task type (empty if no task is running)
+         */
+        std::string PowerMeter::getLabel(const std::set<WorkflowTask *, TaskStartTimeComparator> &tasks) {
+            if (tasks.empty()) {
+                return "";
+            }
+            auto &categories = this->workflow_index->getCategories();
+            return categories.getTypeName(categories.getTaskType(this->workflow_index->getTaskIndex(*tasks.rbegin())));
         }
 
         /**
@@ -69,6 +329,14 @@ namespace wrench {
 
             bool life = true;
 
+            // in exact mode, energy is integrated upon updates, the daemon only waits to be stopped
+            while (this->exact && life) {
+                life = this->processNextMessage(0);
+            }
+            if (this->exact) {
+                this->finish();
+            }
+
             /** Main loop **/
             while (life) {
                 S4U_Simulation::computeZeroFlop();
@@ -97,35 +365,29 @@ namespace wrench {
                     h.second = std::max<double>(0, h.second - (Simulation::getCurrentSimulatedDate() - before));
                 }
 
-                // TODO: add comparator by start time
-                std::map<std::string, std::set<WorkflowTask *>> tasks_per_host;
+                this->updateRunningTasks();
 
                 // Take measurements
                 for (auto &h : this->time_to_next_measurement) {
                     if (h.second < EPSILON) {
-
-                        for (auto task : this->wms->getWorkflow()->getTasks()) {
-
-                            // only process running tasks
-                            if (task->getStartDate() != -1 && task->getEndDate() == -1) {
-                                if (tasks_per_host.find(task->getExecutionHost()) == tasks_per_host.end()) {
-                                    std::set<WorkflowTask *> tasks_set;
-                                    tasks_set.insert(task);
-                                    tasks_per_host.insert(std::make_pair(task->getExecutionHost(), tasks_set));
-                                } else {
-                                    tasks_per_host[task->getExecutionHost()].insert(task);
-                                }
+                        // only process running tasks
+                        auto &tasks = this->running_tasks[h.first];
+                        for (auto it = tasks.begin(); it != tasks.end();) {
+                            if ((*it)->getEndDate() != -1) {
+                                it = tasks.erase(it);
+                            } else {
+                                ++it;
                             }
                         }
 
+                        // compute power consumption, the measurement accounts for the whole period
+                        std::vector<double> task_powers;
+                        this->computePowerMeasurements(h.first, tasks, not tasks.empty(), &task_powers);
+                        this->attributeEnergy(h.first, tasks, task_powers, this->measurement_periods[h.first]);
+
                         this->time_to_next_measurement[h.first] = this->measurement_periods[h.first];
                     }
                 }
-
-                // compute power consumption
-                for (auto &key_value : tasks_per_host) {
-                    this->computePowerMeasurements(key_value.first, key_value.second, true);
-                }
             }
 
             WRENCH_INFO("Energy Meter Manager terminating");
@@ -140,25 +402,26 @@ namespace wrench {
          * @param hostname: the host name
          * @param tasks: list of WorkflowTask running on the host
          * @param record_as_time_stamp: bool signaling whether or not to record a SimulationTimestampEnergyConsumption object
+         * @param task_powers: if not null, the dynamic power of each task (in the order of tasks) is appended to it
          *
          * @return current energy consumption in Watts
          * @throw std::invalid_argument
          */
         double PowerMeter::computePowerMeasurements(const std::string &hostname,
-                                                    std::set<WorkflowTask *> tasks,
-                                                    bool record_as_time_stamp) {
+                                                    const std::set<WorkflowTask *, TaskStartTimeComparator> &tasks,
+                                                    bool record_as_time_stamp, std::vector<double> *task_powers) {
             if (hostname.empty()) {
                 throw std::invalid_argument("Simulation::getEnergyConsumed() requires a valid hostname");
             }
 
             double consumption = S4U_Simulation::getMinPowerConsumption(hostname);
             int task_index = 0;
-            std::string task_name;
+            WorkflowTask *last_task = nullptr;
             double task_factor = 1;
 
             for (auto task : tasks) {
                 double task_consumption = 0;
-                task_name = task->getID();
+                last_task = task;
 
                 // power related to cpu usage
                 // dynamic power per socket
@@ -190,13 +453,15 @@ namespace wrench {
 //            task_consumption *= 1.31;
 
                 consumption += task_consumption;
+                if (task_powers) {
+                    task_powers->push_back(task_consumption);
+                }
                 task_index++;
             }
 
             if (record_as_time_stamp) {
-                if (tasks.size() == S4U_Simulation::getHostNumCores(hostname)) {
-                    this->simulation->getOutput().addTimestampEnergyConsumption(
-                            task_name.substr(0, task_name.find("_")), consumption);
+                if (last_task && tasks.size() == S4U_Simulation::getHostNumCores(hostname)) {
+                    this->simulation->getOutput().addTimestampEnergyConsumption(this->getLabel(tasks), consumption);
                 }
             }
 
@@ -205,6 +470,7 @@ namespace wrench {
 
         /**
          * @brief Process the next message
+         * @param timeout: the time to wait for a message (0 means no timeout)
          * @return true if the daemon should continue, false otherwise
          *
          * @throw std::runtime_error
@@ -213,7 +479,8 @@ namespace wrench {
             std::shared_ptr<SimulationMessage> message = nullptr;
 
             try {
-                message = S4U_Mailbox::getMessage(this->mailbox_name, timeout);
+                message = timeout > 0 ? S4U_Mailbox::getMessage(this->mailbox_name, timeout)
+                                      : S4U_Mailbox::getMessage(this->mailbox_name);
             } catch (std::shared_ptr<NetworkError> &cause) {
                 return true;
             }
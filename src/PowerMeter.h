@@ -12,6 +12,8 @@
 
 #include <wrench-dev.h>
 
+#include "WorkflowIndex.h"
+
 namespace wrench {
     namespace pegasus {
 
@@ -19,12 +21,27 @@ namespace wrench {
 
         class PowerMeter : public Service {
         public:
-            PowerMeter(WMS *wms, const std::vector<std::string> &hostnames, double period, bool pairwise = false);
+            PowerMeter(WMS *wms, const std::vector<std::string> &hostnames, double period, bool pairwise = false,
+                       std::shared_ptr<WorkflowIndex> workflow_index = nullptr, bool exact = false);
 
             void kill();
 
             void stop() override;
 
+            void notifyTasksSubmitted(const std::vector<WorkflowTask *> &tasks);
+
+            void notifyTaskCompleted(WorkflowTask *task);
+
+            void update();
+
+            void finish();
+
+            double getEnergyConsumed(const std::string &hostname);
+
+            double getDynamicEnergyConsumed(const std::string &hostname);
+
+            double getTaskEnergyConsumed(unsigned long id);
+
         protected:
             friend class DAGMan;
 
@@ -32,20 +49,67 @@ namespace wrench {
             int main() override;
 
             struct TaskStartTimeComparator {
-                bool operator()(WorkflowTask *&lhs, WorkflowTask *&rhs);
+                bool operator()(WorkflowTask *lhs, WorkflowTask *rhs) const;
             };
 
+            void updateRunningTasks();
+
+            void integrate(const std::string &hostname, double date);
+
+            std::string getLabel(const std::set<WorkflowTask *, TaskStartTimeComparator> &tasks);
+
             double computePowerMeasurements(const std::string &hostname,
-                                            std::set<WorkflowTask *> tasks,
-                                            bool record_as_time_stamp);
+                                            const std::set<WorkflowTask *, TaskStartTimeComparator> &tasks,
+                                            bool record_as_time_stamp,
+                                            std::vector<double> *task_powers = nullptr);
+
+            void attributeEnergy(const std::string &hostname,
+                                 const std::set<WorkflowTask *, TaskStartTimeComparator> &tasks,
+                                 const std::vector<double> &task_powers, double duration);
 
             bool processNextMessage(double timeout);
 
             // Relevant WMS
             WMS *wms;
             bool pairwise;
+            std::shared_ptr<WorkflowIndex> workflow_index;
             std::map<std::string, double> measurement_periods;
             std::map<std::string, double> time_to_next_measurement;
+            /** @brief Tasks submitted and not started yet */
+            std::set<WorkflowTask *> submitted_tasks;
+            /** @brief Running tasks per execution host, ordered by start time */
+            std::map<std::string, std::set<WorkflowTask *, TaskStartTimeComparator>> running_tasks;
+
+            /**
+             * @brief Power state of a host since its running set last changed (exact mode)
+             */
+            struct HostPower {
+                /** @brief Date of the last change of the running set */
+                double last_change;
+                /** @brief Power since the last change, in Watts */
+                double power;
+                /** @brief Dynamic power of each running task since the last change, in Watts */
+                std::vector<double> task_powers;
+            };
+
+            /**
+             * @brief Energy consumed by a host, split between idle power and the dynamic power of tasks
+             */
+            struct HostEnergy {
+                /** @brief Energy related to the idle power of the host, in Joules */
+                double idle;
+                /** @brief Energy related to the tasks running on the host, in Joules */
+                double dynamic;
+            };
+
+            /** @brief Whether energy is integrated exactly upon changes instead of sampled periodically */
+            bool exact;
+            /** @brief Power state per metered host (exact mode) */
+            std::map<std::string, HostPower> host_power;
+            /** @brief Energy consumed per metered host */
+            std::map<std::string, HostEnergy> host_energy;
+            /** @brief Energy attributed to each task, indexed by dense task ID */
+            std::vector<double> task_energy;
         };
     }
 }
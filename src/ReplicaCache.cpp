@@ -0,0 +1,106 @@
+/**
+ * Copyright (c) 2017-2021. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include "ReplicaCache.h"
+
+namespace wrench {
+    namespace pegasus {
+
+        /**
+         * @brief Constructor
+         *
+         * @param file_registry_service: the file registry service
+         */
+        ReplicaCache::ReplicaCache(std::shared_ptr<FileRegistryService> file_registry_service) :
+                file_registry_service(file_registry_service) {}
+
+        /**
+         * @brief Get the known replica locations of a file. The file registry service is only queried the
+         *        first time a file is looked up; locations added afterwards are merged into the result.
+         *
+         * @param file: the file
+         * @return a set of file locations
+         */
+        std::set<std::shared_ptr<FileLocation>> ReplicaCache::getReplicas(WorkflowFile *file) {
+            auto &file_replicas = this->replicas[file];
+            if (this->registry_lookups.find(file) != this->registry_lookups.end()) {
+                this->hits++;
+                return file_replicas;
+            }
+            this->misses++;
+            this->registry_lookups.insert(file);
+            for (auto &location : this->file_registry_service->lookupEntry(file)) {
+                file_replicas.insert(location);
+            }
+            return file_replicas;
+        }
+
+        /**
+         * @brief Check whether a file is resident on a storage service. The storage service is only queried
+         *        the first time the (file, storage service) pair is looked up.
+         *
+         * @param file: the file
+         * @param storage_service: the storage service
+         * @return true if the file is resident on the storage service
+         */
+        bool ReplicaCache::isResident(WorkflowFile *file, const std::shared_ptr<StorageService> &storage_service) {
+            auto key = std::make_pair(file, storage_service.get());
+            auto it = this->residency.find(key);
+            if (it != this->residency.end()) {
+                this->hits++;
+                return it->second;
+            }
+            this->misses++;
+            bool resident = storage_service->lookupFile(file, FileLocation::LOCATION(storage_service, "/"));
+            this->residency[key] = resident;
+            return resident;
+        }
+
+        /**
+         * @brief Record a new replica of a file (e.g., a staged in file or a job output file)
+         *
+         * @param file: the file
+         * @param location: the location of the new replica
+         */
+        void ReplicaCache::addReplica(WorkflowFile *file, const std::shared_ptr<FileLocation> &location) {
+            this->residency[std::make_pair(file, location->getStorageService().get())] = true;
+            this->replicas[file].insert(location);
+        }
+
+        /**
+         * @brief Forget a file (e.g., a file removed from the workflow)
+         *
+         * @param file: the file
+         */
+        void ReplicaCache::removeFile(WorkflowFile *file) {
+            this->replicas.erase(file);
+            this->registry_lookups.erase(file);
+            auto it = this->residency.lower_bound(std::make_pair(file, (StorageService *) nullptr));
+            while (it != this->residency.end() && it->first.first == file) {
+                it = this->residency.erase(it);
+            }
+        }
+
+        /**
+         * @brief Get the number of lookups answered from the cache
+         * @return the number of cache hits
+         */
+        unsigned long ReplicaCache::getHits() const {
+            return this->hits;
+        }
+
+        /**
+         * @brief Get the number of lookups forwarded to the file registry service or a storage service
+         * @return the number of cache misses
+         */
+        unsigned long ReplicaCache::getMisses() const {
+            return this->misses;
+        }
+    }
+}
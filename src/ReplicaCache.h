@@ -0,0 +1,59 @@
+/**
+ * Copyright (c) 2017-2021. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef PEGASUS_REPLICACACHE_H
+#define PEGASUS_REPLICACACHE_H
+
+#include <map>
+#include <set>
+#include <wrench-dev.h>
+
+namespace wrench {
+    namespace pegasus {
+
+        /**
+         * @brief A cache of replica locations in front of the file registry service and storage services
+         *        lookups. Replica locations are retrieved once per file from the file registry service, and
+         *        residency of files on storage services is checked once per (file, storage service), then
+         *        kept up to date with the files staged in or produced by jobs.
+         */
+        class ReplicaCache {
+        public:
+            explicit ReplicaCache(std::shared_ptr<FileRegistryService> file_registry_service);
+
+            std::set<std::shared_ptr<FileLocation>> getReplicas(WorkflowFile *file);
+
+            bool isResident(WorkflowFile *file, const std::shared_ptr<StorageService> &storage_service);
+
+            void addReplica(WorkflowFile *file, const std::shared_ptr<FileLocation> &location);
+
+            void removeFile(WorkflowFile *file);
+
+            unsigned long getHits() const;
+
+            unsigned long getMisses() const;
+
+        private:
+            /** @brief The file registry service */
+            std::shared_ptr<FileRegistryService> file_registry_service;
+            /** @brief Known replica locations, per file */
+            std::map<WorkflowFile *, std::set<std::shared_ptr<FileLocation>>> replicas;
+            /** @brief Files whose replicas have been retrieved from the file registry service */
+            std::set<WorkflowFile *> registry_lookups;
+            /** @brief Whether a file is resident on a storage service, per (file, storage service) */
+            std::map<std::pair<WorkflowFile *, StorageService *>, bool> residency;
+            /** @brief Number of lookups answered from the cache */
+            unsigned long hits = 0;
+            /** @brief Number of lookups forwarded to the file registry service or a storage service */
+            unsigned long misses = 0;
+        };
+    }
+}
+
+#endif //PEGASUS_REPLICACACHE_H
@@ -0,0 +1,131 @@
+/**
+ * Copyright (c) 2017-2021. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <limits>
+#include <simgrid/s4u.hpp>
+
+#include "ReplicaSelector.h"
+
+namespace wrench {
+    namespace pegasus {
+
+        /**
+         * @brief Select the replica with the lowest estimated transfer time to a storage service
+         *        (ties are broken by the order of the replicas)
+         *
+         * @param file: the file to be transferred
+         * @param replicas: the replica locations of the file
+         * @param dst_storage_service: the storage service the file is transferred to
+         * @return the location of the selected replica
+         *
+         * @throw std::invalid_argument
+         */
+        std::shared_ptr<FileLocation>
+        ReplicaSelector::selectReplica(WorkflowFile *file, const std::set<std::shared_ptr<FileLocation>> &replicas,
+                                       const std::shared_ptr<StorageService> &dst_storage_service) {
+            if (replicas.empty()) {
+                throw std::invalid_argument("ReplicaSelector::selectReplica(): No replica of file " + file->getID());
+            }
+            if (replicas.size() == 1) {
+                return *replicas.begin();
+            }
+
+            std::shared_ptr<FileLocation> selected_replica = nullptr;
+            double best_time = std::numeric_limits<double>::max();
+            for (auto &replica : replicas) {
+                double time = this->estimateTransferTime(file, replica, dst_storage_service);
+                if (time < best_time) {
+                    best_time = time;
+                    selected_replica = replica;
+                }
+            }
+            return selected_replica;
+        }
+
+        /**
+         * @brief Estimate the time to transfer a file from a replica to a storage service
+         *
+         * @param file: the file to be transferred
+         * @param src: the replica location
+         * @param dst_storage_service: the storage service the file is transferred to
+         * @return the estimated transfer time, in seconds
+         */
+        double ReplicaSelector::estimateTransferTime(WorkflowFile *file, const std::shared_ptr<FileLocation> &src,
+                                                     const std::shared_ptr<StorageService> &dst_storage_service) {
+            auto &route = this->getRoute(src->getStorageService()->getHostname(), dst_storage_service->getHostname());
+            if (route.bandwidth == std::numeric_limits<double>::infinity()) {
+                return route.latency;
+            }
+
+            // the bandwidth is shared with the transfers in flight from the same source
+            unsigned long transfers = 1;
+            auto it = this->inflight_transfers.find(src->getStorageService().get());
+            if (it != this->inflight_transfers.end()) {
+                transfers += it->second;
+            }
+            return route.latency + file->getSize() * transfers / route.bandwidth;
+        }
+
+        /**
+         * @brief Account for a transfer initiated from a replica
+         *
+         * @param src: the replica location
+         */
+        void ReplicaSelector::notifyTransferStarted(const std::shared_ptr<FileLocation> &src) {
+            this->inflight_transfers[src->getStorageService().get()]++;
+        }
+
+        /**
+         * @brief Account for a transfer from a replica that has completed (or failed)
+         *
+         * @param src: the replica location
+         *
+         * @throw std::runtime_error
+         */
+        void ReplicaSelector::notifyTransferCompleted(const std::shared_ptr<FileLocation> &src) {
+            auto it = this->inflight_transfers.find(src->getStorageService().get());
+            if (it == this->inflight_transfers.end() || it->second == 0) {
+                throw std::runtime_error("ReplicaSelector::notifyTransferCompleted(): No transfer in flight from " +
+                                         src->toString());
+            }
+            if (--it->second == 0) {
+                this->inflight_transfers.erase(it);
+            }
+        }
+
+        /**
+         * @brief Get the latency and bottleneck bandwidth of the route between two hosts
+         *
+         * @param src_hostname: the source hostname
+         * @param dst_hostname: the destination hostname
+         * @return the route characteristics
+         */
+        const ReplicaSelector::Route &ReplicaSelector::getRoute(const std::string &src_hostname,
+                                                                const std::string &dst_hostname) {
+            auto key = std::make_pair(src_hostname, dst_hostname);
+            auto it = this->routes.find(key);
+            if (it != this->routes.end()) {
+                return it->second;
+            }
+
+            Route route;
+            route.latency = 0;
+            route.bandwidth = std::numeric_limits<double>::infinity();
+            if (src_hostname != dst_hostname) {
+                std::vector<simgrid::s4u::Link *> links;
+                simgrid::s4u::Host::by_name(src_hostname)->route_to(simgrid::s4u::Host::by_name(dst_hostname), links,
+                                                                     &route.latency);
+                for (auto link : links) {
+                    route.bandwidth = std::min(route.bandwidth, link->get_bandwidth());
+                }
+            }
+            return this->routes[key] = route;
+        }
+    }
+}
@@ -0,0 +1,60 @@
+/**
+ * Copyright (c) 2017-2021. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef PEGASUS_REPLICASELECTOR_H
+#define PEGASUS_REPLICASELECTOR_H
+
+#include <map>
+#include <set>
+#include <string>
+#include <wrench-dev.h>
+
+namespace wrench {
+    namespace pegasus {
+
+        /**
+         * @brief Selection of the replica to stage in a file from, based on the estimated transfer time from
+         *        each source: route latency and bottleneck bandwidth (from the platform description), with the
+         *        bandwidth shared among the transfers in flight from the same source.
+         */
+        class ReplicaSelector {
+        public:
+            std::shared_ptr<FileLocation> selectReplica(WorkflowFile *file,
+                                                        const std::set<std::shared_ptr<FileLocation>> &replicas,
+                                                        const std::shared_ptr<StorageService> &dst_storage_service);
+
+            double estimateTransferTime(WorkflowFile *file, const std::shared_ptr<FileLocation> &src,
+                                        const std::shared_ptr<StorageService> &dst_storage_service);
+
+            void notifyTransferStarted(const std::shared_ptr<FileLocation> &src);
+
+            void notifyTransferCompleted(const std::shared_ptr<FileLocation> &src);
+
+        private:
+            /**
+             * @brief Network characteristics of the route between two hosts
+             */
+            struct Route {
+                /** @brief Route latency, in seconds */
+                double latency;
+                /** @brief Bandwidth of the bottleneck link, in bytes per second */
+                double bandwidth;
+            };
+
+            const Route &getRoute(const std::string &src_hostname, const std::string &dst_hostname);
+
+            /** @brief Routes between (source, destination) hosts, computed on first use */
+            std::map<std::pair<std::string, std::string>, Route> routes;
+            /** @brief Number of transfers in flight per source storage service */
+            std::map<StorageService *, unsigned long> inflight_transfers;
+        };
+    }
+}
+
+#endif //PEGASUS_REPLICASELECTOR_H
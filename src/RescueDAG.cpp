@@ -0,0 +1,183 @@
+/**
+ * Copyright (c) 2017-2021. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <fstream>
+#include <set>
+#include <nlohmann/json.hpp>
+
+#include "RescueDAG.h"
+
+namespace wrench {
+    namespace pegasus {
+
+        /**
+         * @brief Load completed tasks from a rescue file
+         *
+         * @param filename: the rescue file path
+         *
+         * @throw std::invalid_argument
+         */
+        void RescueDAG::load(const std::string &filename) {
+            std::ifstream file;
+            nlohmann::json json_data;
+
+            file.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+            try {
+                file.open(filename);
+                file >> json_data;
+            } catch (const std::ifstream::failure &e) {
+                throw std::invalid_argument("RescueDAG::load(): Invalid rescue file " + filename);
+            }
+
+            try {
+                for (auto &task : json_data.at("completed_tasks")) {
+                    CompletedTask completed_task;
+                    completed_task.task_id = task.at("id").get<std::string>();
+                    for (auto &output : task.at("outputs")) {
+                        OutputFile output_file;
+                        output_file.file_id = output.at("file").get<std::string>();
+                        output_file.hostname = output.at("host").get<std::string>();
+                        output_file.size = output.value("size", 0.0);
+                        completed_task.outputs.push_back(output_file);
+                    }
+                    if (isSubWorkflowTask(completed_task.task_id)) {
+                        this->sub_workflow_task_ids.insert(completed_task.task_id);
+                    }
+                    this->completed_tasks.push_back(completed_task);
+                }
+            } catch (nlohmann::json::exception &e) {
+                throw std::invalid_argument("RescueDAG::load(): Invalid rescue file " + filename + ": " + e.what());
+            }
+        }
+
+        /**
+         * @brief Write the completed tasks to a rescue file
+         *
+         * @param filename: the rescue file path
+         *
+         * @throw std::runtime_error
+         */
+        void RescueDAG::write(const std::string &filename) const {
+            nlohmann::json json_tasks = nlohmann::json::array();
+            for (auto &completed_task : this->completed_tasks) {
+                nlohmann::json json_outputs = nlohmann::json::array();
+                for (auto &output : completed_task.outputs) {
+                    json_outputs.push_back({{"file", output.file_id},
+                                            {"host", output.hostname},
+                                            {"size", output.size}});
+                }
+                json_tasks.push_back({{"id",      completed_task.task_id},
+                                      {"outputs", json_outputs}});
+            }
+
+            std::ofstream file(filename);
+            if (not file) {
+                throw std::runtime_error("RescueDAG::write(): Unable to write rescue file " + filename);
+            }
+            file << nlohmann::json({{"completed_tasks", json_tasks}}).dump(2) << "\n";
+        }
+
+        /**
+         * @brief Record a completed task
+         *
+         * @param task: the completed task
+         * @param storage_hostname: the name of the host of the storage service holding the task output files
+         */
+        void RescueDAG::addCompletedTask(WorkflowTask *task, const std::string &storage_hostname) {
+            CompletedTask completed_task;
+            completed_task.task_id = task->getID();
+            for (auto file : task->getOutputFiles()) {
+                OutputFile output_file;
+                output_file.file_id = file->getID();
+                output_file.hostname = storage_hostname;
+                output_file.size = file->getSize();
+                completed_task.outputs.push_back(output_file);
+            }
+            this->completed_tasks.push_back(completed_task);
+        }
+
+        /**
+         * @brief Get the number of completed tasks
+         * @return the number of completed tasks
+         */
+        unsigned long RescueDAG::getNumberOfCompletedTasks() const {
+            return this->completed_tasks.size();
+        }
+
+        /**
+         * @brief Remove the completed tasks from a workflow, so that only the remaining tasks are simulated.
+         *        Output files of completed tasks then become input files of the workflow. Completed tasks of
+         *        sub-workflows are skipped when their sub-workflow is expanded, and their output files are added
+         *        to the workflow.
+         *
+         * @param workflow: the workflow
+         * @return a map of the output files of the completed tasks and the name of the host holding them
+         *
+         * @throw std::invalid_argument
+         */
+        std::map<WorkflowFile *, std::string> RescueDAG::apply(Workflow *workflow) const {
+            std::set<WorkflowTask *> tasks;
+            for (auto &completed_task : this->completed_tasks) {
+                if (not isSubWorkflowTask(completed_task.task_id)) {
+                    tasks.insert(workflow->getTaskByID(completed_task.task_id));
+                }
+            }
+
+            // a task can only complete after its parents
+            for (auto task : tasks) {
+                for (auto parent : workflow->getTaskParents(task)) {
+                    if (tasks.find(parent) == tasks.end()) {
+                        throw std::invalid_argument("RescueDAG::apply(): Task " + task->getID() +
+                                                    " completed before its parent " + parent->getID());
+                    }
+                }
+            }
+
+            std::map<WorkflowFile *, std::string> output_files;
+            for (auto &completed_task : this->completed_tasks) {
+                for (auto &output : completed_task.outputs) {
+                    WorkflowFile *file;
+                    try {
+                        file = workflow->getFileByID(output.file_id);
+                    } catch (std::invalid_argument &e) {
+                        if (not isSubWorkflowTask(completed_task.task_id)) {
+                            throw;
+                        }
+                        file = workflow->addFile(output.file_id, output.size);
+                    }
+                    output_files[file] = output.hostname;
+                }
+            }
+            for (auto task : tasks) {
+                workflow->removeTask(task);
+            }
+            return output_files;
+        }
+
+        /**
+         * @brief Get whether a task of a sub-workflow was completed in the previous run
+         *
+         * @param task_id: the task ID (with "@" suffix)
+         * @return true if the task has completed
+         */
+        bool RescueDAG::isCompletedSubWorkflowTask(const std::string &task_id) const {
+            return this->sub_workflow_task_ids.find(task_id) != this->sub_workflow_task_ids.end();
+        }
+
+        /**
+         * @brief Get whether a task belongs to a sub-workflow, i.e., whether its ID has an "@<node ID>" suffix
+         *
+         * @param task_id: the task ID
+         * @return true if the task belongs to a sub-workflow
+         */
+        bool RescueDAG::isSubWorkflowTask(const std::string &task_id) {
+            return task_id.find('@') != std::string::npos;
+        }
+    }
+}
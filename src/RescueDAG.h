@@ -0,0 +1,73 @@
+/**
+ * Copyright (c) 2017-2021. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef PEGASUS_RESCUEDAG_H
+#define PEGASUS_RESCUEDAG_H
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include <wrench-dev.h>
+
+namespace wrench {
+    namespace pegasus {
+
+        /**
+         * @brief A DAGMan rescue file: the list of completed tasks and the locations of their output files,
+         *        used to resume a simulation without re-running completed tasks
+         */
+        class RescueDAG {
+        public:
+            void load(const std::string &filename);
+
+            void write(const std::string &filename) const;
+
+            void addCompletedTask(WorkflowTask *task, const std::string &storage_hostname);
+
+            unsigned long getNumberOfCompletedTasks() const;
+
+            std::map<WorkflowFile *, std::string> apply(Workflow *workflow) const;
+
+            bool isCompletedSubWorkflowTask(const std::string &task_id) const;
+
+        private:
+            /**
+             * @brief An output file of a completed task
+             */
+            struct OutputFile {
+                /** @brief The file ID */
+                std::string file_id;
+                /** @brief The name of the host of the storage service holding the file */
+                std::string hostname;
+                /** @brief The file size (bytes) */
+                double size;
+            };
+
+            /**
+             * @brief A completed task and the locations of its output files
+             */
+            struct CompletedTask {
+                /** @brief The task ID */
+                std::string task_id;
+                /** @brief The output files */
+                std::vector<OutputFile> outputs;
+            };
+
+            static bool isSubWorkflowTask(const std::string &task_id);
+
+            /** @brief Completed tasks, in order of completion */
+            std::vector<CompletedTask> completed_tasks;
+            /** @brief IDs of the loaded completed tasks of sub-workflows, which are skipped upon expansion */
+            std::set<std::string> sub_workflow_task_ids;
+        };
+    }
+}
+
+#endif //PEGASUS_RESCUEDAG_H
@@ -0,0 +1,160 @@
+/**
+ * Copyright (c) 2017-2021. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "RuntimePerturbation.h"
+
+#define MIN_PERTURBATION_FACTOR 0.01
+
+namespace wrench {
+    namespace pegasus {
+
+        /**
+         * @brief Constructor
+         *
+         * @param settings: perturbation settings per task category ("*" for the default settings)
+         * @param distribution: the distribution of the factors ("normal" or "uniform")
+         *
+         * @throw std::invalid_argument
+         */
+        RuntimePerturbation::RuntimePerturbation(const std::map<std::string, Settings> &settings,
+                                                 const std::string &distribution) : settings(settings) {
+            if (distribution != "normal" && distribution != "uniform") {
+                throw std::invalid_argument("RuntimePerturbation::RuntimePerturbation(): Invalid distribution " +
+                                            distribution + " (should be normal or uniform)");
+            }
+            this->uniform = distribution == "uniform";
+        }
+
+        /**
+         * @brief Get whether no category is perturbed
+         * @return true if applying the perturbation leaves the workflow unchanged
+         */
+        bool RuntimePerturbation::isEmpty() const {
+            for (auto &category : this->settings) {
+                if (category.second.flops > 0 || category.second.file_size > 0) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /**
+         * @brief Create a perturbed copy of a workflow: the flops of each task are multiplied by a factor drawn
+         *        from the distribution of its category, and so is the size of each file, using the category of
+         *        the task producing it (or the default settings for workflow input files). Factors are drawn in
+         *        task ID order, so that a given seed always yields the same copy.
+         *
+         * @param workflow: the workflow
+         * @param seed: the random seed
+         * @param transformations: the transformations of the workflow tasks, which are their categories (tasks
+         *                         with no transformation are categorized by their ID prefix)
+         * @return the perturbed workflow (owned by the caller)
+         */
+        Workflow *RuntimePerturbation::apply(Workflow *workflow, unsigned long seed,
+                                             const TaskCategoryRegistry::TransformationMap &transformations) const {
+            std::mt19937_64 generator(seed);
+
+            auto tasks = workflow->getTasks();
+            std::sort(tasks.begin(), tasks.end(), [](WorkflowTask *a, WorkflowTask *b) {
+                return a->getID() < b->getID();
+            });
+
+            // file size factors, drawn from the category of the producing task
+            std::map<WorkflowFile *, double> file_factors;
+            for (auto task : tasks) {
+                const Settings &category_settings = this->getSettings(
+                        TaskCategoryRegistry::getCategoryName(task->getID(), transformations));
+                for (auto file : task->getOutputFiles()) {
+                    file_factors[file] = this->drawFactor(category_settings.file_size, generator);
+                }
+            }
+            auto files = workflow->getFiles();
+            std::sort(files.begin(), files.end(), [](WorkflowFile *a, WorkflowFile *b) {
+                return a->getID() < b->getID();
+            });
+
+            auto perturbed_workflow = new Workflow();
+            for (auto file : files) {
+                auto it = file_factors.find(file);
+                double factor = it != file_factors.end() ? it->second
+                                                         : this->drawFactor(this->getSettings("*").file_size,
+                                                                            generator);
+                perturbed_workflow->addFile(file->getID(), file->getSize() * factor);
+            }
+
+            for (auto task : tasks) {
+                const Settings &category_settings = this->getSettings(
+                        TaskCategoryRegistry::getCategoryName(task->getID(), transformations));
+                auto perturbed_task = perturbed_workflow->addTask(
+                        task->getID(), task->getFlops() * this->drawFactor(category_settings.flops, generator),
+                        task->getMinNumCores(), task->getMaxNumCores(), task->getMemoryRequirement());
+                perturbed_task->setAverageCPU(task->getAverageCPU());
+                perturbed_task->setBytesRead(task->getBytesRead());
+                perturbed_task->setBytesWritten(task->getBytesWritten());
+                perturbed_task->setPriority(task->getPriority());
+                for (auto file : task->getInputFiles()) {
+                    perturbed_task->addInputFile(perturbed_workflow->getFileByID(file->getID()));
+                }
+                for (auto file : task->getOutputFiles()) {
+                    perturbed_task->addOutputFile(perturbed_workflow->getFileByID(file->getID()));
+                }
+            }
+
+            for (auto task : tasks) {
+                auto perturbed_task = perturbed_workflow->getTaskByID(task->getID());
+                for (auto parent : workflow->getTaskParents(task)) {
+                    perturbed_workflow->addControlDependency(perturbed_workflow->getTaskByID(parent->getID()),
+                                                             perturbed_task);
+                }
+            }
+
+            return perturbed_workflow;
+        }
+
+        /**
+         * @brief Get the perturbation settings of a category
+         *
+         * @param category: the canonical category name
+         * @return the settings of the category, otherwise the default settings (no perturbation if not set)
+         */
+        const RuntimePerturbation::Settings &RuntimePerturbation::getSettings(const std::string &category) const {
+            static const Settings none = {0, 0};
+            auto it = this->settings.find(category);
+            if (it == this->settings.end()) {
+                it = this->settings.find("*");
+            }
+            return it == this->settings.end() ? none : it->second;
+        }
+
+        /**
+         * @brief Draw a multiplicative factor of mean 1
+         *
+         * @param cv: the coefficient of variation of the factor
+         * @param generator: the random number generator
+         * @return the factor (at least MIN_PERTURBATION_FACTOR)
+         */
+        double RuntimePerturbation::drawFactor(double cv, std::mt19937_64 &generator) const {
+            if (cv <= 0) {
+                return 1;
+            }
+            double factor;
+            if (this->uniform) {
+                // a uniform distribution over [1 - a, 1 + a] has a standard deviation of a / sqrt(3)
+                double half_width = cv * std::sqrt(3.0);
+                factor = std::uniform_real_distribution<double>(1 - half_width, 1 + half_width)(generator);
+            } else {
+                factor = std::normal_distribution<double>(1, cv)(generator);
+            }
+            return std::max(factor, MIN_PERTURBATION_FACTOR);
+        }
+    }
+}
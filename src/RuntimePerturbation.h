@@ -0,0 +1,60 @@
+/**
+ * Copyright (c) 2017-2021. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef PEGASUS_RUNTIMEPERTURBATION_H
+#define PEGASUS_RUNTIMEPERTURBATION_H
+
+#include <map>
+#include <random>
+#include <string>
+#include <wrench-dev.h>
+
+#include "TaskCategoryRegistry.h"
+
+namespace wrench {
+    namespace pegasus {
+
+        /**
+         * @brief Seeded random perturbation of task flops and file sizes, drawn from per-category distributions
+         *        of mean 1, used to simulate replicas of a workflow execution (Monte-Carlo ensembles)
+         */
+        class RuntimePerturbation {
+        public:
+            /**
+             * @brief Perturbation settings of a category, as coefficients of variation of the multiplicative factor
+             */
+            struct Settings {
+                /** @brief Coefficient of variation of the task flops factor (0 if not perturbed) */
+                double flops;
+                /** @brief Coefficient of variation of the output file size factor (0 if not perturbed) */
+                double file_size;
+            };
+
+            RuntimePerturbation(const std::map<std::string, Settings> &settings = {},
+                                const std::string &distribution = "normal");
+
+            bool isEmpty() const;
+
+            Workflow *apply(Workflow *workflow, unsigned long seed,
+                            const TaskCategoryRegistry::TransformationMap &transformations = {}) const;
+
+        private:
+            const Settings &getSettings(const std::string &category) const;
+
+            double drawFactor(double cv, std::mt19937_64 &generator) const;
+
+            /** @brief Perturbation settings per task category ("*" for the default settings) */
+            std::map<std::string, Settings> settings;
+            /** @brief Whether factors are drawn from a uniform distribution (otherwise a truncated normal) */
+            bool uniform;
+        };
+    }
+}
+
+#endif //PEGASUS_RUNTIMEPERTURBATION_H
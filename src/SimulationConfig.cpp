@@ -18,7 +18,7 @@ namespace wrench {
 
         /**
          * @brief Load the simulation properties for configuring the simulation. It also creates and configures the
-         *        HTCondorComputeService object.
+         *        HTCondorComputeService objects (one per HTCondor pool).
          *
          * @param simulation: pointer to simulation object
          * @param filename: File path for the properties file
@@ -41,6 +41,104 @@ namespace wrench {
             this->submit_hostname = getPropertyValue<std::string>("submit_host", json_data);
             this->file_registry_hostname = getPropertyValue<std::string>("file_registry_host", json_data);
             this->energy_scheme = getPropertyValue<std::string>("energy_scheme", json_data, false);
+            std::string energy_integration = getPropertyValue<std::string>("energy_integration", json_data, false,
+                                                                           "sampling");
+            if (energy_integration != "sampling" && energy_integration != "exact") {
+                throw std::invalid_argument("SimulationConfig::loadProperties(): Invalid energy integration: " +
+                                            energy_integration);
+            }
+            this->exact_energy = energy_integration == "exact";
+
+            // DAGMan settings
+            if (json_data.find("dagman") != json_data.end()) {
+                nlohmann::json dagman = json_data.at("dagman");
+                this->dagman_event_driven = getPropertyValue<bool>("event_driven", dagman, false);
+                this->dagman_coalesce_window = getPropertyValue<double>("coalesce_window", dagman, false);
+
+                // throttling
+                DAGManThrottle defaults;
+                std::map<std::string, unsigned long> category_max_jobs;
+                if (dagman.find("category_maxjobs") != dagman.end()) {
+                    for (auto &category : dagman.at("category_maxjobs").items()) {
+                        category_max_jobs[category.key()] = category.value().get<unsigned long>();
+                    }
+                }
+                this->dagman_throttle = DAGManThrottle(
+                        getPropertyValue<unsigned long>("maxjobs", dagman, false, defaults.getMaxJobs()),
+                        getPropertyValue<unsigned long>("maxidle", dagman, false, defaults.getMaxIdle()),
+                        getPropertyValue<unsigned long>("max_submits_per_interval", dagman, false,
+                                                        defaults.getMaxSubmitsPerInterval()),
+                        getPropertyValue<double>("submit_interval", dagman, false, defaults.getSubmitInterval()),
+                        getPropertyValue<double>("bootstrap_delay", dagman, false, defaults.getBootstrapDelay()),
+                        getPropertyValue<unsigned long>("max_register_jobs", dagman, false,
+                                                        defaults.getMaxRegisterJobs()),
+                        category_max_jobs);
+            }
+
+            // job placement across HTCondor pools
+            std::string placement = getPropertyValue<std::string>("placement", json_data, false, "load");
+            if (placement != "load" && placement != "locality") {
+                throw std::invalid_argument("SimulationConfig::loadProperties(): Invalid placement policy: " +
+                                            placement);
+            }
+            this->locality_aware_placement = placement == "locality";
+
+            // stage-in settings
+            if (json_data.find("stage_in") != json_data.end()) {
+                nlohmann::json stage_in = json_data.at("stage_in");
+                this->asynchronous_stage_in = getPropertyValue<bool>("asynchronous", stage_in, false);
+                this->max_concurrent_transfers = getPropertyValue<unsigned long>("max_concurrent_transfers",
+                                                                                 stage_in, false);
+            }
+
+            // horizontal job clustering
+            if (json_data.find("clusters") != json_data.end()) {
+                for (auto &category : json_data.at("clusters").items()) {
+                    JobClustering::Settings settings;
+                    settings.size = getPropertyValue<unsigned long>("size", category.value(), false);
+                    settings.num = getPropertyValue<unsigned long>("num", category.value(), false);
+                    this->clustering_settings[category.key()] = settings;
+                }
+            }
+
+            // runtime perturbation of ensemble replicas
+            if (json_data.find("perturbation") != json_data.end()) {
+                nlohmann::json perturbation = json_data.at("perturbation");
+                std::map<std::string, RuntimePerturbation::Settings> perturbation_settings;
+                if (perturbation.find("categories") != perturbation.end()) {
+                    for (auto &category : perturbation.at("categories").items()) {
+                        RuntimePerturbation::Settings settings;
+                        settings.flops = getPropertyValue<double>("flops", category.value(), false);
+                        settings.file_size = getPropertyValue<double>("file_size", category.value(), false);
+                        perturbation_settings[category.key()] = settings;
+                    }
+                }
+                this->runtime_perturbation = RuntimePerturbation(
+                        perturbation_settings,
+                        getPropertyValue<std::string>("distribution", perturbation, false, "normal"));
+            }
+
+            // placement of the workflow input files on the storage hosts
+            if (json_data.find("input_placement") != json_data.end()) {
+                nlohmann::json input_placement = json_data.at("input_placement");
+                std::map<std::string, std::vector<std::string>> patterns;
+                if (input_placement.find("hosts") != input_placement.end()) {
+                    for (auto &host : input_placement.at("hosts").items()) {
+                        patterns[host.key()] = host.value().get<std::vector<std::string>>();
+                    }
+                }
+                this->input_placement = InputPlacement(
+                        patterns,
+                        getPropertyValue<std::string>("policy", input_placement, false, "all"),
+                        getPropertyValue<unsigned long>("replicas", input_placement, false, 1));
+            }
+
+            // inner workflows of sub-workflow nodes (hierarchical workflows)
+            if (json_data.find("subworkflows") != json_data.end()) {
+                for (auto &node : json_data.at("subworkflows").items()) {
+                    this->sub_workflows[node.key()] = node.value().get<std::string>();
+                }
+            }
 
             // storage resources
             std::vector<nlohmann::json> storage_resources = json_data.at("storage_hosts");
@@ -54,8 +152,40 @@ namespace wrench {
                 this->storage_services.insert(storage_service);
             }
 
+            // HTCondor pools: a single pool on the submit host, unless several pools are defined
+            if (json_data.find("pools") != json_data.end()) {
+                std::vector<nlohmann::json> pools = json_data.at("pools");
+                if (pools.empty()) {
+                    throw std::invalid_argument("SimulationConfig::loadProperties(): No HTCondor pool defined");
+                }
+                for (auto &pool : pools) {
+                    instantiateHTCondorPool(
+                            simulation,
+                            getPropertyValue<std::string>("name", pool),
+                            getPropertyValue<std::string>("submit_host", pool, false, this->submit_hostname),
+                            pool.at("compute_services"));
+                }
+            } else {
+                instantiateHTCondorPool(simulation, "local", this->submit_hostname, json_data.at("compute_services"));
+            }
+        }
+
+        /**
+         * @brief Instantiate a HTCondorComputeService (i.e., a HTCondor pool) and its local storage service
+         *
+         * @param simulation: pointer to simulation object
+         * @param pool_name: the name of the pool
+         * @param pool_hostname: the name of the host running the pool services and its local storage
+         * @param compute_resources: the JSON description of the compute services of the pool
+         *
+         * @throw std::invalid_argument
+         */
+        void SimulationConfig::instantiateHTCondorPool(wrench::Simulation &simulation, const std::string &pool_name,
+                                                       const std::string &pool_hostname,
+                                                       const std::vector<nlohmann::json> &compute_resources) {
+            unsigned long first_execution_host = this->execution_hosts.size();
+
             // compute resources
-            std::vector<nlohmann::json> compute_resources = json_data.at("compute_services");
             for (auto &resource : compute_resources) {
                 std::string type = getPropertyValue<std::string>("type", resource);
 
@@ -72,15 +202,24 @@ namespace wrench {
             }
 
             // build the HTCondorComputeService
-            this->htcondor_service = simulation.add(
-                    new HTCondorComputeService(this->submit_hostname, "local", std::move(this->compute_services),
+            WRENCH_INFO("Instantiating HTCondor pool %s on: %s", pool_name.c_str(), pool_hostname.c_str());
+            auto htcondor_service = simulation.add(
+                    new HTCondorComputeService(pool_hostname, pool_name, std::move(this->compute_services),
                                                {{ComputeServiceProperty::SUPPORTS_PILOT_JOBS, "false"}}));
+            this->compute_services.clear();
 
             // creating local storage service
-            auto local_storage_service = simulation.add(
-                    new SimpleStorageService(this->submit_hostname, {"/"}));
+            auto local_storage_service = simulation.add(new SimpleStorageService(pool_hostname, {"/"}));
             local_storage_service->setNetworkTimeoutValue(30);
-            this->htcondor_service->setLocalStorageService(local_storage_service);
+            htcondor_service->setLocalStorageService(local_storage_service);
+
+            // number of slots of the pool (one per core)
+            unsigned long slots = 0;
+            for (unsigned long i = first_execution_host; i < this->execution_hosts.size(); i++) {
+                slots += Simulation::getHostNumCores(this->execution_hosts[i]);
+            }
+            this->htcondor_services.push_back(htcondor_service);
+            this->htcondor_slots[htcondor_service] = slots;
         }
 
         /**
@@ -100,11 +239,20 @@ namespace wrench {
         }
 
         /**
-         * @brief Get a pointer to the HTCondorComputeService
-         * @return A pointer to the HTCondorComputeService
+         * @brief Get pointers to the HTCondorComputeServices (one per HTCondor pool)
+         * @return A set of HTCondorComputeServices
+         */
+        std::set<std::shared_ptr<HTCondorComputeService>> SimulationConfig::getHTCondorServices() {
+            return std::set<std::shared_ptr<HTCondorComputeService>>(this->htcondor_services.begin(),
+                                                                     this->htcondor_services.end());
+        }
+
+        /**
+         * @brief Get the number of slots (cores) of each HTCondor pool
+         * @return A map of number of slots indexed by HTCondorComputeService
          */
-        std::shared_ptr<HTCondorComputeService> SimulationConfig::getHTCondorService() {
-            return this->htcondor_service;
+        std::map<std::shared_ptr<HTCondorComputeService>, unsigned long> SimulationConfig::getHTCondorSlots() {
+            return this->htcondor_slots;
         }
 
         /**
@@ -143,6 +291,94 @@ namespace wrench {
             return this->energy_scheme;
         }
 
+        /**
+         * @brief Get whether energy is integrated exactly upon changes of the running tasks of hosts
+         * @return true for exact energy integration, false for periodic sampling
+         */
+        bool SimulationConfig::isExactEnergy() {
+            return this->exact_energy;
+        }
+
+        /**
+         * @brief Get whether DAGMan should be woken up upon job completions instead of polling
+         * @return true if DAGMan is event-driven
+         */
+        bool SimulationConfig::isDAGManEventDriven() {
+            return this->dagman_event_driven;
+        }
+
+        /**
+         * @brief Get the time window for coalescing job completions in event-driven mode
+         * @return the coalescing window in seconds
+         */
+        double SimulationConfig::getDAGManCoalesceWindow() {
+            return this->dagman_coalesce_window;
+        }
+
+        /**
+         * @brief Get the DAGMan throttling settings
+         * @return the DAGMan throttling settings
+         */
+        DAGManThrottle SimulationConfig::getDAGManThrottle() {
+            return this->dagman_throttle;
+        }
+
+        /**
+         * @brief Get whether jobs are placed on the HTCondor pool holding most of their input data
+         * @return true for data-locality-aware placement
+         */
+        bool SimulationConfig::isLocalityAwarePlacement() {
+            return this->locality_aware_placement;
+        }
+
+        /**
+         * @brief Get whether input files are staged in asynchronously
+         * @return true if input files are staged in asynchronously
+         */
+        bool SimulationConfig::isAsynchronousStageIn() {
+            return this->asynchronous_stage_in;
+        }
+
+        /**
+         * @brief Get the maximum number of concurrent stage-in transfers
+         * @return the maximum number of concurrent transfers (0 means unlimited)
+         */
+        unsigned long SimulationConfig::getMaxConcurrentTransfers() {
+            return this->max_concurrent_transfers;
+        }
+
+        /**
+         * @brief Get the horizontal clustering settings per task category
+         * @return a map of clustering settings indexed by task category
+         */
+        std::map<std::string, JobClustering::Settings> SimulationConfig::getClusteringSettings() {
+            return this->clustering_settings;
+        }
+
+        /**
+         * @brief Get the perturbation of task flops and file sizes applied to ensemble replicas
+         * @return the runtime perturbation (empty if not set)
+         */
+        RuntimePerturbation SimulationConfig::getRuntimePerturbation() {
+            return this->runtime_perturbation;
+        }
+
+        /**
+         * @brief Get the placement of the workflow input files on the storage hosts
+         * @return the input placement (every input file on every storage host if not set)
+         */
+        InputPlacement SimulationConfig::getInputPlacement() {
+            return this->input_placement;
+        }
+
+        /**
+         * @brief Get the inner workflow files of the sub-workflow nodes
+         * @return a map of DAX or JSON workflow files indexed by sub-workflow node task ID (empty if not set)
+         */
+        std::map<std::string, std::string> SimulationConfig::getSubWorkflows() {
+            return this->sub_workflows;
+        }
+
         /**
          * @brief Instantiate wrench::MultihostMulticoreComputeService
          *
@@ -13,6 +13,11 @@
 #include <nlohmann/json.hpp>
 #include <wrench-dev.h>
 
+#include "DAGManThrottle.h"
+#include "InputPlacement.h"
+#include "JobClustering.h"
+#include "RuntimePerturbation.h"
+
 namespace wrench {
     namespace pegasus {
 
@@ -24,7 +29,9 @@ namespace wrench {
 
             std::string getFileRegistryHostname();
 
-            std::shared_ptr<HTCondorComputeService> getHTCondorService();
+            std::set<std::shared_ptr<HTCondorComputeService>> getHTCondorServices();
+
+            std::map<std::shared_ptr<HTCondorComputeService>, unsigned long> getHTCondorSlots();
 
             std::set<std::shared_ptr<StorageService>> getStorageServices();
 
@@ -34,7 +41,33 @@ namespace wrench {
 
             std::string getEnergyScheme();
 
+            bool isExactEnergy();
+
+            bool isDAGManEventDriven();
+
+            double getDAGManCoalesceWindow();
+
+            DAGManThrottle getDAGManThrottle();
+
+            std::map<std::string, JobClustering::Settings> getClusteringSettings();
+
+            RuntimePerturbation getRuntimePerturbation();
+
+            InputPlacement getInputPlacement();
+
+            std::map<std::string, std::string> getSubWorkflows();
+
+            bool isLocalityAwarePlacement();
+
+            bool isAsynchronousStageIn();
+
+            unsigned long getMaxConcurrentTransfers();
+
         private:
+            void instantiateHTCondorPool(wrench::Simulation &simulation, const std::string &pool_name,
+                                         const std::string &pool_hostname,
+                                         const std::vector<nlohmann::json> &compute_resources);
+
             void instantiateBareMetal(std::vector<std::string> hosts);
 
             void instantiateCloud(std::string service_host, std::vector<std::string> hosts);
@@ -46,17 +79,19 @@ namespace wrench {
              * @param keyName: property key that will be searched for
              * @param jsonData: JSON object to extract the value for the provided key
              * @param required: whether the property must exist
+             * @param default_value: the value returned if the property is optional and missing
              *
              * @throw std::invalid_argument
              * @return The value for the provided key, if present
              */
             template<class T>
-            T getPropertyValue(const std::string &keyName, const nlohmann::json &jsonData, const bool required = true) {
+            T getPropertyValue(const std::string &keyName, const nlohmann::json &jsonData, const bool required = true,
+                               const T &default_value = T()) {
                 if (jsonData.find(keyName) == jsonData.end()) {
                     if (required) {
                         throw std::invalid_argument("SimulationConfig::loadProperties(): Unable to find " + keyName);
                     } else {
-                        return T();
+                        return default_value;
                     }
                 }
                 return jsonData.at(keyName);
@@ -67,8 +102,20 @@ namespace wrench {
             std::set<ComputeService *> compute_services;
             std::set<std::shared_ptr<StorageService>> storage_services;
             std::vector<std::string> execution_hosts;
-            std::shared_ptr<HTCondorComputeService> htcondor_service;
+            std::vector<std::shared_ptr<HTCondorComputeService>> htcondor_services;
+            std::map<std::shared_ptr<HTCondorComputeService>, unsigned long> htcondor_slots;
             std::string energy_scheme;
+            bool exact_energy = false;
+            bool dagman_event_driven = false;
+            double dagman_coalesce_window = 0;
+            DAGManThrottle dagman_throttle;
+            std::map<std::string, JobClustering::Settings> clustering_settings;
+            RuntimePerturbation runtime_perturbation;
+            InputPlacement input_placement;
+            std::map<std::string, std::string> sub_workflows;
+            bool locality_aware_placement = false;
+            bool asynchronous_stage_in = false;
+            unsigned long max_concurrent_transfers = 0;
         };
 
     }
@@ -0,0 +1,186 @@
+/**
+ * Copyright (c) 2017-2021. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <memory>
+#include <wrench/tools/pegasus/PegasusWorkflowParser.h>
+
+#include "SubWorkflowExpander.h"
+#include "WorkflowCache.h"
+
+XBT_LOG_NEW_DEFAULT_CATEGORY(SubWorkflowExpander, "Log category for SubWorkflowExpander");
+
+namespace wrench {
+    namespace pegasus {
+
+        /**
+         * @brief Constructor
+         *
+         * @param sub_workflows: the inner workflow file (DAX or JSON) of each sub-workflow node, indexed by node
+         *                       task ID (the ID in the workflow that contains the node, without "@" suffix)
+         */
+        SubWorkflowExpander::SubWorkflowExpander(const std::map<std::string, std::string> &sub_workflows) :
+                sub_workflows(sub_workflows) {}
+
+        /**
+         * @brief Get whether a task is a sub-workflow node
+         *
+         * @param task_id: the task ID
+         * @return true if the task is a sub-workflow node
+         */
+        bool SubWorkflowExpander::isSubWorkflowNode(const std::string &task_id) const {
+            return this->find(task_id) != this->sub_workflows.end();
+        }
+
+        /**
+         * @brief Parse the inner workflow of a sub-workflow node and add its tasks to the running workflow
+         *
+         * @param workflow: the running workflow
+         * @param node: the sub-workflow node
+         * @param transformations: if not null, the transformations of the added tasks are added to it
+         * @param rescue_dag: if not null, inner tasks it lists as completed in a previous run are not added
+         * @return the tasks added to the running workflow
+         *
+         * @throw std::invalid_argument
+         */
+        std::vector<WorkflowTask *>
+        SubWorkflowExpander::expand(Workflow *workflow, WorkflowTask *node,
+                                    TaskCategoryRegistry::TransformationMap *transformations,
+                                    const RescueDAG *rescue_dag) {
+            auto it = this->find(node->getID());
+            if (it == this->sub_workflows.end()) {
+                throw std::invalid_argument("SubWorkflowExpander::expand(): " + node->getID() +
+                                            " is not a sub-workflow node");
+            }
+            const std::string &workflow_file = it->second;
+
+            std::unique_ptr<Workflow> inner_workflow;
+            TaskCategoryRegistry::TransformationMap inner_transformations;
+            std::string cache_file = WorkflowCache::getCacheFilename(workflow_file);
+            std::string extension = workflow_file.substr(workflow_file.find_last_of('.') + 1);
+            if (WorkflowCache::isValid(cache_file, workflow_file)) {
+                inner_workflow.reset(WorkflowCache::load(cache_file, &inner_transformations));
+            } else if (extension == "xml") {
+                inner_workflow.reset(PegasusWorkflowParser::createWorkflowFromDAX(workflow_file, "1f"));
+                inner_transformations = TaskCategoryRegistry::readTransformations(workflow_file);
+            } else if (extension == "json") {
+                inner_workflow.reset(PegasusWorkflowParser::createWorkflowFromJSON(workflow_file, "1f"));
+            } else {
+                throw std::invalid_argument("SubWorkflowExpander::expand(): Invalid workflow file name " +
+                                            workflow_file + " (should be *.xml or *.json)");
+            }
+
+            // inner files are shared with the running workflow by ID, e.g., to consume outputs of outer tasks;
+            // files added by expansions are reference counted, to be removed once released
+            std::map<WorkflowFile *, WorkflowFile *> files;
+            auto &node_files = this->expanded_files[node->getID()];
+            for (auto inner_file : inner_workflow->getFiles()) {
+                WorkflowFile *file;
+                try {
+                    file = workflow->getFileByID(inner_file->getID());
+                    auto references = this->file_references.find(file);
+                    if (references != this->file_references.end()) {
+                        references->second++;
+                        node_files.push_back(file);
+                    }
+                } catch (std::invalid_argument &e) {
+                    file = workflow->addFile(inner_file->getID(), inner_file->getSize());
+                    this->file_references[file] = 1;
+                    node_files.push_back(file);
+                }
+                files[inner_file] = file;
+            }
+
+            std::vector<WorkflowTask *> tasks;
+            std::map<WorkflowTask *, WorkflowTask *> inner_tasks;
+            std::string suffix = "@" + node->getID();
+            for (auto inner_task : inner_workflow->getTasks()) {
+                if (rescue_dag && rescue_dag->isCompletedSubWorkflowTask(inner_task->getID() + suffix)) {
+                    continue;
+                }
+                auto task = workflow->addTask(inner_task->getID() + suffix, inner_task->getFlops(),
+                                              inner_task->getMinNumCores(), inner_task->getMaxNumCores(),
+                                              inner_task->getMemoryRequirement());
+                task->setPriority(inner_task->getPriority());
+                task->setAverageCPU(inner_task->getAverageCPU());
+                task->setBytesRead(inner_task->getBytesRead());
+                task->setBytesWritten(inner_task->getBytesWritten());
+                for (auto file : inner_task->getInputFiles()) {
+                    task->addInputFile(files.at(file));
+                }
+                for (auto file : inner_task->getOutputFiles()) {
+                    task->addOutputFile(files.at(file));
+                }
+                inner_tasks[inner_task] = task;
+                tasks.push_back(task);
+                auto transformation = inner_transformations.find(inner_task->getID());
+                if (transformations && transformation != inner_transformations.end()) {
+                    (*transformations)[task->getID()] = transformation->second;
+                }
+            }
+            for (auto &inner_task : inner_tasks) {
+                for (auto parent : inner_workflow->getTaskParents(inner_task.first)) {
+                    // parents completed in a previous run are not added
+                    auto parent_task = inner_tasks.find(parent);
+                    if (parent_task != inner_tasks.end()) {
+                        workflow->addControlDependency(parent_task->second, inner_task.second);
+                    }
+                }
+            }
+
+            WRENCH_INFO("Expanded sub-workflow %s (%s) into %lu tasks", node->getID().c_str(), workflow_file.c_str(),
+                        tasks.size());
+            return tasks;
+        }
+
+        /**
+         * @brief Remove the (completed) tasks of an expanded sub-workflow from the running workflow
+         *
+         * @param workflow: the running workflow
+         * @param node: the sub-workflow node
+         * @param tasks: the tasks of the sub-workflow
+         * @return the files added by expansions that no expanded sub-workflow uses anymore, to be removed from
+         *         the running workflow once deleted from storage services
+         */
+        std::vector<WorkflowFile *>
+        SubWorkflowExpander::release(Workflow *workflow, WorkflowTask *node, const std::vector<WorkflowTask *> &tasks) {
+            for (auto task : tasks) {
+                workflow->removeTask(task);
+            }
+
+            std::vector<WorkflowFile *> released_files;
+            auto node_files = this->expanded_files.find(node->getID());
+            if (node_files == this->expanded_files.end()) {
+                return released_files;
+            }
+            for (auto file : node_files->second) {
+                if (--this->file_references[file] == 0) {
+                    this->file_references.erase(file);
+                    released_files.push_back(file);
+                }
+            }
+            this->expanded_files.erase(node_files);
+            return released_files;
+        }
+
+        /**
+         * @brief Find the inner workflow file of a task, by its full ID or else by its ID in the inner workflow
+         *        it was expanded from (i.e., without "@" suffix)
+         *
+         * @param task_id: the task ID
+         * @return an iterator to the inner workflow file, or the end iterator if the task is not a node
+         */
+        std::map<std::string, std::string>::const_iterator SubWorkflowExpander::find(const std::string &task_id) const {
+            auto it = this->sub_workflows.find(task_id);
+            if (it == this->sub_workflows.end() && task_id.find('@') != std::string::npos) {
+                it = this->sub_workflows.find(task_id.substr(0, task_id.find('@')));
+            }
+            return it;
+        }
+    }
+}
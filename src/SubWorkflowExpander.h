@@ -0,0 +1,60 @@
+/**
+ * Copyright (c) 2017-2021. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef PEGASUS_SUBWORKFLOWEXPANDER_H
+#define PEGASUS_SUBWORKFLOWEXPANDER_H
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <wrench-dev.h>
+
+#include "RescueDAG.h"
+#include "TaskCategoryRegistry.h"
+
+namespace wrench {
+    namespace pegasus {
+
+        /**
+         * @brief Lazy expansion of the sub-workflow nodes of a hierarchical workflow (Pegasus SUBDAG/SUBDAX
+         *        jobs): the inner DAX or JSON workflow of a node is only parsed and added to the running workflow
+         *        when the node becomes ready, and its tasks are removed once they have all completed. Inner task
+         *        IDs are suffixed with "@<node ID>" to keep them unique across sub-workflows; inner files are
+         *        shared with the running workflow by file ID, and files added by expansions are removed once
+         *        no expanded sub-workflow uses them.
+         */
+        class SubWorkflowExpander {
+        public:
+            explicit SubWorkflowExpander(const std::map<std::string, std::string> &sub_workflows);
+
+            bool isSubWorkflowNode(const std::string &task_id) const;
+
+            std::vector<WorkflowTask *>
+            expand(Workflow *workflow, WorkflowTask *node,
+                   TaskCategoryRegistry::TransformationMap *transformations = nullptr,
+                   const RescueDAG *rescue_dag = nullptr);
+
+            std::vector<WorkflowFile *>
+            release(Workflow *workflow, WorkflowTask *node, const std::vector<WorkflowTask *> &tasks);
+
+        private:
+            std::map<std::string, std::string>::const_iterator find(const std::string &task_id) const;
+
+            /** @brief Inner workflow file of each sub-workflow node, indexed by node task ID */
+            std::map<std::string, std::string> sub_workflows;
+            /** @brief Files added by expansions and used by expanded sub-workflows, indexed by node task ID */
+            std::unordered_map<std::string, std::vector<WorkflowFile *>> expanded_files;
+            /** @brief Number of expanded sub-workflows using each file added by an expansion */
+            std::unordered_map<WorkflowFile *, unsigned long> file_references;
+        };
+    }
+}
+
+#endif //PEGASUS_SUBWORKFLOWEXPANDER_H
@@ -0,0 +1,307 @@
+/**
+ * Copyright (c) 2017-2021. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <nlohmann/json.hpp>
+
+#include "SweepRunner.h"
+
+namespace wrench {
+    namespace pegasus {
+
+        /**
+         * @brief Constructor
+         *
+         * @param manifest_filename: the sweep manifest path, a JSON file of the form
+         *        {"workers": 4, "output_dir": "sweep", "scenarios": [{"name": "...", "platform": "...",
+         *        "workflow": "...", "config": "...", "args": ["..."]}]}, where workers (defaults to the number
+         *        of cores), output_dir (defaults to "sweep"), name, and args are optional
+         *
+         * @throw std::invalid_argument
+         */
+        SweepRunner::SweepRunner(const std::string &manifest_filename) {
+            std::ifstream file;
+            nlohmann::json json_data;
+
+            file.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+            try {
+                file.open(manifest_filename);
+                file >> json_data;
+            } catch (const std::ifstream::failure &e) {
+                throw std::invalid_argument("SweepRunner::SweepRunner(): Invalid sweep manifest " + manifest_filename);
+            }
+
+            try {
+                this->workers = json_data.value("workers", (unsigned long) std::thread::hardware_concurrency());
+                this->output_dir = json_data.value("output_dir", std::string("sweep"));
+
+                for (auto &json_scenario : json_data.at("scenarios")) {
+                    std::vector<std::string> args;
+                    args.push_back(json_scenario.at("platform").get<std::string>());
+                    args.push_back(json_scenario.at("workflow").get<std::string>());
+                    args.push_back(json_scenario.at("config").get<std::string>());
+                    if (json_scenario.find("args") != json_scenario.end()) {
+                        for (auto &arg : json_scenario.at("args")) {
+                            args.push_back(arg.get<std::string>());
+                        }
+                    }
+                    this->addScenario(
+                            json_scenario.value("name", "scenario-" + std::to_string(this->scenarios.size())), args);
+                }
+            } catch (nlohmann::json::exception &e) {
+                throw std::invalid_argument("SweepRunner::SweepRunner(): Invalid sweep manifest " +
+                                            manifest_filename + ": " + e.what());
+            }
+
+            if (this->workers == 0) {
+                this->workers = 1;
+            }
+        }
+
+        /**
+         * @brief Constructor
+         *
+         * @param workers: maximum number of scenarios run concurrently (0 for the number of cores)
+         * @param output_dir: directory scenario outputs and results are written to
+         */
+        SweepRunner::SweepRunner(unsigned long workers, const std::string &output_dir) :
+                workers(workers ? workers : std::thread::hardware_concurrency()), output_dir(output_dir) {
+            if (this->workers == 0) {
+                this->workers = 1;
+            }
+        }
+
+        /**
+         * @brief Add a scenario to the sweep
+         *
+         * @param name: the scenario name, unique within the sweep (used as a file name in the output directory)
+         * @param args: the simulator arguments (platform, workflow, config, and additional options). Unless
+         *              set, the run summary is written to <output_dir>/<name>.json
+         *
+         * @throw std::invalid_argument
+         */
+        void SweepRunner::addScenario(const std::string &name, const std::vector<std::string> &args) {
+            if (name.empty() || name.find('/') != std::string::npos || name.find("..") != std::string::npos) {
+                throw std::invalid_argument("SweepRunner::addScenario(): Invalid scenario name " + name +
+                                            " (should not be empty or contain '/' or '..')");
+            }
+            for (auto &scenario : this->scenarios) {
+                if (scenario.name == name) {
+                    throw std::invalid_argument("SweepRunner::addScenario(): Duplicate scenario name " + name);
+                }
+            }
+            Scenario scenario;
+            scenario.name = name;
+            scenario.args = args;
+            scenario.output_filename = this->output_dir + "/" + name + ".log";
+            for (auto &arg : args) {
+                if (arg.find("--summary=") == 0) {
+                    scenario.summary_filename = arg.substr(std::string("--summary=").size());
+                }
+            }
+            if (scenario.summary_filename.empty()) {
+                scenario.summary_filename = this->output_dir + "/" + name + ".json";
+                scenario.args.push_back("--summary=" + scenario.summary_filename);
+            }
+            this->scenarios.push_back(scenario);
+        }
+
+        /**
+         * @brief Run all scenarios, keeping up to the configured number of simulator processes running, and
+         *        write the results file once all of them have terminated
+         *
+         * @param executable: the simulator executable (searched in the PATH if it contains no slash)
+         * @return the number of scenarios that failed
+         *
+         * @throw std::runtime_error
+         */
+        int SweepRunner::run(const std::string &executable) {
+            if (mkdir(this->output_dir.c_str(), 0755) != 0 && errno != EEXIST) {
+                throw std::runtime_error("SweepRunner::run(): Unable to create output directory " +
+                                         this->output_dir + ": " + std::strerror(errno));
+            }
+
+            std::cerr << "Running " << this->scenarios.size() << " scenarios with " << this->workers
+                      << " worker(s)" << std::endl;
+
+            std::map<pid_t, std::pair<unsigned long, std::chrono::steady_clock::time_point>> running;
+            unsigned long next = 0;
+            int failed = 0;
+
+            while (next < this->scenarios.size() || not running.empty()) {
+                while (next < this->scenarios.size() && running.size() < this->workers) {
+                    auto &scenario = this->scenarios[next];
+                    pid_t pid = this->launch(scenario, executable);
+                    if (pid < 0) {
+                        // the scenario fails, the others keep running
+                        failed++;
+                        std::cerr << "Scenario " << scenario.name << " could not be started: " << scenario.error
+                                  << std::endl;
+                    } else {
+                        running[pid] = std::make_pair(next, std::chrono::steady_clock::now());
+                    }
+                    next++;
+                }
+                if (running.empty()) {
+                    continue;
+                }
+
+                int status;
+                pid_t pid = waitpid(-1, &status, 0);
+                if (pid < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    // the running scenarios cannot be waited for anymore
+                    std::string error = std::string("waitpid failed: ") + std::strerror(errno);
+                    for (auto &process : running) {
+                        this->scenarios[process.second.first].error = error;
+                        failed++;
+                    }
+                    running.clear();
+                    std::cerr << "SweepRunner::run(): " << error << std::endl;
+                    continue;
+                }
+                auto it = running.find(pid);
+                if (it == running.end()) {
+                    continue;
+                }
+
+                auto &scenario = this->scenarios[it->second.first];
+                scenario.elapsed = std::chrono::duration<double>(
+                        std::chrono::steady_clock::now() - it->second.second).count();
+                if (WIFEXITED(status)) {
+                    scenario.exit_code = WEXITSTATUS(status);
+                } else if (WIFSIGNALED(status)) {
+                    scenario.signal = WTERMSIG(status);
+                }
+                running.erase(it);
+
+                if (scenario.exit_code != 0) {
+                    failed++;
+                    std::cerr << "Scenario " << scenario.name << " failed ("
+                              << (scenario.signal ? "signal " + std::to_string(scenario.signal)
+                                                  : "exit code " + std::to_string(scenario.exit_code))
+                              << "), see " << scenario.output_filename << std::endl;
+                } else {
+                    std::cerr << "Scenario " << scenario.name << " completed in " << scenario.elapsed << "s"
+                              << std::endl;
+                }
+            }
+
+            this->writeResults();
+            std::cerr << this->scenarios.size() - failed << " scenario(s) completed, " << failed << " failed"
+                      << std::endl;
+            return failed;
+        }
+
+        /**
+         * @brief Get the number of scenarios of the sweep
+         * @return the number of scenarios
+         */
+        unsigned long SweepRunner::getNumberOfScenarios() const {
+            return this->scenarios.size();
+        }
+
+        /**
+         * @brief Start a simulator process for a scenario, with its standard output and error redirected to
+         *        the scenario output file
+         *
+         * @param scenario: the scenario
+         * @param executable: the simulator executable
+         * @return the process ID (-1 if the process could not be started, the reason being recorded as the
+         *         scenario error)
+         */
+        pid_t SweepRunner::launch(Scenario &scenario, const std::string &executable) {
+            // prepared before forking, so that the child only calls async-signal-safe functions
+            std::vector<char *> argv;
+            argv.push_back(const_cast<char *>(executable.c_str()));
+            for (auto &arg : scenario.args) {
+                argv.push_back(const_cast<char *>(arg.c_str()));
+            }
+            argv.push_back(nullptr);
+
+            pid_t pid = fork();
+            if (pid < 0) {
+                scenario.error = std::string("fork failed: ") + std::strerror(errno);
+                return -1;
+            }
+            if (pid == 0) {
+                int fd = open(scenario.output_filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+                if (fd < 0) {
+                    _exit(127);
+                }
+                dup2(fd, STDOUT_FILENO);
+                dup2(fd, STDERR_FILENO);
+                close(fd);
+                execvp(argv[0], argv.data());
+                _exit(127);
+            }
+            return pid;
+        }
+
+        /**
+         * @brief Write the outcome of all scenarios, merged with their run summaries (makespan, whether the
+         *        workflow completed, and energy), to the results file (sweep.json in the output directory)
+         *
+         * @throw std::runtime_error
+         */
+        void SweepRunner::writeResults() const {
+            nlohmann::json json_scenarios = nlohmann::json::array();
+            for (auto &scenario : this->scenarios) {
+                nlohmann::json json_scenario = {{"name",      scenario.name},
+                                                {"args",      scenario.args},
+                                                {"output",    scenario.output_filename},
+                                                {"exit_code", scenario.exit_code},
+                                                {"signal",    scenario.signal},
+                                                {"elapsed",   scenario.elapsed},
+                                                {"succeeded", scenario.exit_code == 0}};
+                if (not scenario.error.empty()) {
+                    json_scenario["error"] = scenario.error;
+                }
+
+                // failed scenarios may have no summary
+                std::ifstream summary_file(scenario.summary_filename);
+                if (summary_file) {
+                    nlohmann::json summary;
+                    try {
+                        summary_file >> summary;
+                        for (auto key : {"makespan", "completed", "energy"}) {
+                            if (summary.find(key) != summary.end()) {
+                                json_scenario[key] = summary.at(key);
+                            }
+                        }
+                    } catch (nlohmann::json::exception &e) {
+                        std::cerr << "Ignoring invalid summary of scenario " << scenario.name << ": " << e.what()
+                                  << std::endl;
+                    }
+                }
+                json_scenarios.push_back(json_scenario);
+            }
+
+            std::string filename = this->output_dir + "/sweep.json";
+            std::ofstream file(filename);
+            if (not file) {
+                throw std::runtime_error("SweepRunner::writeResults(): Unable to write results file " + filename);
+            }
+            file << nlohmann::json({{"scenarios", json_scenarios}}).dump(2) << "\n";
+        }
+    }
+}
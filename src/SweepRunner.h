@@ -0,0 +1,75 @@
+/**
+ * Copyright (c) 2017-2021. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef PEGASUS_SWEEPRUNNER_H
+#define PEGASUS_SWEEPRUNNER_H
+
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+namespace wrench {
+    namespace pegasus {
+
+        /**
+         * @brief Runs the scenarios (platform, workflow, and simulation config triples) listed in a sweep
+         *        manifest, each in its own simulator process, using a pool of worker processes. The output of
+         *        each scenario is written to its own file, and the outcome and run summary (makespan, energy) of
+         *        all scenarios to a single results file, so that a failing scenario does not affect the others.
+         */
+        class SweepRunner {
+        public:
+            explicit SweepRunner(const std::string &manifest_filename);
+
+            SweepRunner(unsigned long workers, const std::string &output_dir);
+
+            void addScenario(const std::string &name, const std::vector<std::string> &args);
+
+            int run(const std::string &executable);
+
+            unsigned long getNumberOfScenarios() const;
+
+        private:
+            /**
+             * @brief A scenario of the sweep and its outcome
+             */
+            struct Scenario {
+                /** @brief The scenario name (unique within the sweep) */
+                std::string name;
+                /** @brief Simulator arguments: platform, workflow, config, and additional options */
+                std::vector<std::string> args;
+                /** @brief Path of the file the scenario output is written to */
+                std::string output_filename;
+                /** @brief Path of the file the scenario run summary is written to (--summary option) */
+                std::string summary_filename;
+                /** @brief Reason why the simulator process could not be run or waited for (empty if none) */
+                std::string error;
+                /** @brief Exit code of the simulator process (-1 if it did not exit normally) */
+                int exit_code = -1;
+                /** @brief Signal that terminated the simulator process (0 if none) */
+                int signal = 0;
+                /** @brief Wall-clock time of the scenario, in seconds */
+                double elapsed = 0;
+            };
+
+            pid_t launch(Scenario &scenario, const std::string &executable);
+
+            void writeResults() const;
+
+            /** @brief The scenarios of the sweep, in manifest order */
+            std::vector<Scenario> scenarios;
+            /** @brief Maximum number of scenarios run concurrently */
+            unsigned long workers;
+            /** @brief Directory scenario outputs and results are written to */
+            std::string output_dir;
+        };
+    }
+}
+
+#endif //PEGASUS_SWEEPRUNNER_H
@@ -0,0 +1,258 @@
+/**
+ * Copyright (c) 2017-2021. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <stdexcept>
+#include <pugixml.hpp>
+
+#include "TaskCategoryRegistry.h"
+
+namespace wrench {
+    namespace pegasus {
+
+        /**
+         * @brief Get the canonical category name for a task ID (e.g., "mDiffFit_ID00001" -> "mDiffFit",
+         *        "stage_in_local_0_0" -> "stage_in", "clean_up_1" -> "clean_up", "create_dir_0" -> "create_dir")
+         *
+         * @param task_id: a task ID
+         * @return the canonical category name
+         */
+        std::string TaskCategoryRegistry::getCanonicalName(const std::string &task_id) {
+            std::string name = getTypeName(task_id);
+            if (name == "clean") {
+                return "clean_up";
+            } else if (name == "stage") {
+                return task_id.substr(0, task_id.find('_', task_id.find('_') + 1));
+            } else if (name == "create") {
+                return "create_dir";
+            }
+            return name;
+        }
+
+        /**
+         * @brief Get the type name for a task ID, i.e., the task ID prefix up to the first '_'
+         *
+         * @param task_id: a task ID
+         * @return the type name
+         */
+        std::string TaskCategoryRegistry::getTypeName(const std::string &task_id) {
+            return task_id.substr(0, task_id.find('_'));
+        }
+
+        /**
+         * @brief Read the transformation of each task of a workflow file: the job name of DAX files. JSON files
+         *        provide none, their task IDs being prefixed with the transformation.
+         *
+         * @param workflow_filename: the DAX or JSON workflow file
+         * @return the transformations indexed by task ID (empty if none)
+         *
+         * @throw std::invalid_argument
+         */
+        TaskCategoryRegistry::TransformationMap TaskCategoryRegistry::readTransformations(
+                const std::string &workflow_filename) {
+            TransformationMap transformations;
+            std::string extension = workflow_filename.substr(workflow_filename.find_last_of('.') + 1);
+            if (extension != "xml") {
+                return transformations;
+            }
+
+            pugi::xml_document dax_tree;
+            if (not dax_tree.load_file(workflow_filename.c_str())) {
+                throw std::invalid_argument("TaskCategoryRegistry::readTransformations(): Invalid DAX file " +
+                                            workflow_filename);
+            }
+            for (pugi::xml_node job = dax_tree.child("adag").child("job"); job; job = job.next_sibling("job")) {
+                std::string transformation = job.attribute("name").value();
+                if (not transformation.empty()) {
+                    transformations[job.attribute("id").value()] = transformation;
+                }
+            }
+            return transformations;
+        }
+
+        /**
+         * @brief Set the transformations of tasks to be registered (tasks with no transformation fall back to
+         *        their ID prefix)
+         *
+         * @param transformations: transformations indexed by task ID
+         */
+        void TaskCategoryRegistry::addTransformations(const TransformationMap &transformations) {
+            this->transformations.insert(transformations.begin(), transformations.end());
+        }
+
+        /**
+         * @brief Get the category name of a task: its transformation if known, or else derived from its ID
+         *
+         * @param task_id: the task ID
+         * @param transformations: transformations indexed by task ID
+         * @return the canonical category name
+         */
+        std::string TaskCategoryRegistry::getCategoryName(const std::string &task_id,
+                                                          const TransformationMap &transformations) {
+            std::string category_name, type_name;
+            getNames(task_id, transformations, category_name, type_name);
+            return category_name;
+        }
+
+        /**
+         * @brief Get the category and type names of a task. The category is the task transformation if known,
+         *        or else derived from the task ID. Pegasus auxiliary jobs (stage_in, stage_out, clean_up,
+         *        create_dir, register) are grouped into types by their name prefix, other transformations are
+         *        types of their own (e.g., "individuals_merge").
+         *
+         * @param task_id: the task ID
+         * @param transformations: transformations indexed by task ID
+         * @param category_name: set to the canonical category name
+         * @param type_name: set to the type name
+         */
+        void TaskCategoryRegistry::getNames(const std::string &task_id, const TransformationMap &transformations,
+                                            std::string &category_name, std::string &type_name) {
+            auto it = transformations.find(task_id);
+            const std::string &name = it != transformations.end() ? it->second : task_id;
+            type_name = getTypeName(name);
+            bool auxiliary = type_name == "stage" || type_name == "clean" || type_name == "create" ||
+                             type_name == "register";
+            if (auxiliary || it == transformations.end()) {
+                category_name = getCanonicalName(name);
+            } else {
+                category_name = name;
+                type_name = name;
+            }
+        }
+
+        /**
+         * @brief Register the next task (tasks must be added in dense ID order)
+         *
+         * @param task_id: the task ID
+         * @return the task category ID
+         */
+        unsigned int TaskCategoryRegistry::addTask(const std::string &task_id) {
+            std::string category_name, type_name;
+            getNames(task_id, this->transformations, category_name, type_name);
+            // the transformation is only needed once
+            this->transformations.erase(task_id);
+
+            auto it = this->category_ids.find(category_name);
+            unsigned int category;
+            if (it == this->category_ids.end()) {
+                category = this->intern(category_name, this->category_ids, this->category_names);
+                this->category_types.push_back(this->intern(type_name, this->type_ids, this->type_names));
+            } else {
+                category = it->second;
+            }
+            this->task_categories.push_back(category);
+            return category;
+        }
+
+        /**
+         * @brief Get the number of registered tasks
+         * @return number of tasks
+         */
+        unsigned long TaskCategoryRegistry::getNumberOfTasks() const {
+            return this->task_categories.size();
+        }
+
+        /**
+         * @brief Get the number of categories
+         * @return number of categories
+         */
+        unsigned int TaskCategoryRegistry::getNumberOfCategories() const {
+            return this->category_names.size();
+        }
+
+        /**
+         * @brief Get the number of types
+         * @return number of types
+         */
+        unsigned int TaskCategoryRegistry::getNumberOfTypes() const {
+            return this->type_names.size();
+        }
+
+        /**
+         * @brief Get the category of a task
+         *
+         * @param id: a task dense ID
+         * @return the category ID
+         */
+        unsigned int TaskCategoryRegistry::getTaskCategory(unsigned long id) const {
+            return this->task_categories[id];
+        }
+
+        /**
+         * @brief Get the type of a task
+         *
+         * @param id: a task dense ID
+         * @return the type ID
+         */
+        unsigned int TaskCategoryRegistry::getTaskType(unsigned long id) const {
+            return this->category_types[this->task_categories[id]];
+        }
+
+        /**
+         * @brief Get the canonical name of a category
+         *
+         * @param category: a category ID
+         * @return the canonical name
+         */
+        const std::string &TaskCategoryRegistry::getCategoryName(unsigned int category) const {
+            return this->category_names[category];
+        }
+
+        /**
+         * @brief Get the type of a category
+         *
+         * @param category: a category ID
+         * @return the type ID
+         */
+        unsigned int TaskCategoryRegistry::getCategoryType(unsigned int category) const {
+            return this->category_types[category];
+        }
+
+        /**
+         * @brief Get the name of a type
+         *
+         * @param type: a type ID
+         * @return the type name
+         */
+        const std::string &TaskCategoryRegistry::getTypeName(unsigned int type) const {
+            return this->type_names[type];
+        }
+
+        /**
+         * @brief Check whether a type corresponds to register jobs
+         *
+         * @param type: a type ID
+         * @return true if tasks of this type are register jobs
+         */
+        bool TaskCategoryRegistry::isRegisterType(unsigned int type) const {
+            return this->type_names[type] == "register";
+        }
+
+        /**
+         * @brief Intern a name
+         *
+         * @param name: the name
+         * @param ids: IDs by name
+         * @param names: names by ID
+         *
+         * @return the ID of the name
+         */
+        unsigned int TaskCategoryRegistry::intern(const std::string &name,
+                                                  std::unordered_map<std::string, unsigned int> &ids,
+                                                  std::vector<std::string> &names) {
+            auto it = ids.find(name);
+            if (it != ids.end()) {
+                return it->second;
+            }
+            unsigned int id = names.size();
+            ids.insert(std::make_pair(name, id));
+            names.push_back(name);
+            return id;
+        }
+    }
+}
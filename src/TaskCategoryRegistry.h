@@ -0,0 +1,88 @@
+/**
+ * Copyright (c) 2017-2021. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef PEGASUS_TASKCATEGORYREGISTRY_H
+#define PEGASUS_TASKCATEGORYREGISTRY_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace wrench {
+    namespace pegasus {
+
+        /**
+         * @brief A registry of task categories built once at workflow load. Each task is mapped to a small
+         *        integer category ID, which has a canonical name (e.g., "mDiffFit", "stage_in", "clean_up") and
+         *        a type used by DAGMan to run tasks of a single type at once (e.g., "stage" for both "stage_in"
+         *        and "stage_out"). The category is the task transformation when the workflow file provides one
+         *        (e.g., the job name of DAX files, whose task IDs are "ID00000", "ID00001", etc.), and is
+         *        otherwise derived from the task ID prefix (e.g., "mDiffFit_ID00001" in JSON files).
+         */
+        class TaskCategoryRegistry {
+        public:
+            /** @brief Transformation of each task, indexed by task ID */
+            typedef std::unordered_map<std::string, std::string> TransformationMap;
+
+            static std::string getCanonicalName(const std::string &task_id);
+
+            static std::string getTypeName(const std::string &task_id);
+
+            static TransformationMap readTransformations(const std::string &workflow_filename);
+
+            static std::string getCategoryName(const std::string &task_id, const TransformationMap &transformations);
+
+            void addTransformations(const TransformationMap &transformations);
+
+            unsigned int addTask(const std::string &task_id);
+
+            unsigned long getNumberOfTasks() const;
+
+            unsigned int getNumberOfCategories() const;
+
+            unsigned int getNumberOfTypes() const;
+
+            unsigned int getTaskCategory(unsigned long id) const;
+
+            unsigned int getTaskType(unsigned long id) const;
+
+            const std::string &getCategoryName(unsigned int category) const;
+
+            unsigned int getCategoryType(unsigned int category) const;
+
+            const std::string &getTypeName(unsigned int type) const;
+
+            bool isRegisterType(unsigned int type) const;
+
+        private:
+            static void getNames(const std::string &task_id, const TransformationMap &transformations,
+                                 std::string &category_name, std::string &type_name);
+
+            unsigned int intern(const std::string &name, std::unordered_map<std::string, unsigned int> &ids,
+                                std::vector<std::string> &names);
+
+            /** @brief Category of each task, indexed by dense task ID */
+            std::vector<unsigned int> task_categories;
+            /** @brief Canonical category names, indexed by category ID */
+            std::vector<std::string> category_names;
+            /** @brief Type of each category, indexed by category ID */
+            std::vector<unsigned int> category_types;
+            /** @brief Type names, indexed by type ID */
+            std::vector<std::string> type_names;
+            /** @brief Category IDs by canonical name */
+            std::unordered_map<std::string, unsigned int> category_ids;
+            /** @brief Type IDs by name */
+            std::unordered_map<std::string, unsigned int> type_ids;
+            /** @brief Transformations of the tasks not registered yet, indexed by task ID */
+            TransformationMap transformations;
+        };
+    }
+}
+
+#endif //PEGASUS_TASKCATEGORYREGISTRY_H
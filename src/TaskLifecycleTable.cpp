@@ -0,0 +1,139 @@
+/**
+ * Copyright (c) 2017-2021. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <algorithm>
+#include <wrench-dev.h>
+
+#include "TaskLifecycleTable.h"
+#include "WorkflowIndex.h"
+
+namespace wrench {
+    namespace pegasus {
+
+        /**
+         * @brief Constructor
+         *
+         * @param num_tasks: the number of tasks of the workflow
+         */
+        TaskLifecycleTable::TaskLifecycleTable(unsigned long num_tasks) :
+                submitted_dates(num_tasks, -1), scheduled_dates(num_tasks, -1), completion_dates(num_tasks, -1) {}
+
+        /**
+         * @brief Grow the table for a larger number of tasks (e.g., when a sub-workflow is expanded)
+         *
+         * @param num_tasks: the number of tasks of the workflow
+         */
+        void TaskLifecycleTable::resize(unsigned long num_tasks) {
+            this->submitted_dates.resize(num_tasks, -1);
+            this->scheduled_dates.resize(num_tasks, -1);
+            this->completion_dates.resize(num_tasks, -1);
+        }
+
+        /**
+         * @brief Record that a task has been submitted by DAGMan (at the current simulated date)
+         *
+         * @param id: the dense task ID
+         */
+        void TaskLifecycleTable::recordSubmitted(unsigned long id) {
+            this->submitted_dates[id] = S4U_Simulation::getClock();
+        }
+
+        /**
+         * @brief Record that a task has been scheduled on a HTCondor pool (at the current simulated date)
+         *
+         * @param id: the dense task ID
+         */
+        void TaskLifecycleTable::recordScheduled(unsigned long id) {
+            this->scheduled_dates[id] = S4U_Simulation::getClock();
+        }
+
+        /**
+         * @brief Record that the completion of a task has been processed by DAGMan (at the current simulated date)
+         *
+         * @param id: the dense task ID
+         */
+        void TaskLifecycleTable::recordCompleted(unsigned long id) {
+            this->completion_dates[id] = S4U_Simulation::getClock();
+        }
+
+        /**
+         * @brief Get the date a task was (last) submitted by DAGMan
+         *
+         * @param id: the dense task ID
+         * @return the date (negative if the task was never submitted)
+         */
+        double TaskLifecycleTable::getSubmittedDate(unsigned long id) const {
+            return this->submitted_dates[id];
+        }
+
+        /**
+         * @brief Get the date a task was (last) scheduled on a HTCondor pool
+         *
+         * @param id: the dense task ID
+         * @return the date (negative if the task was never scheduled)
+         */
+        double TaskLifecycleTable::getScheduledDate(unsigned long id) const {
+            return this->scheduled_dates[id];
+        }
+
+        /**
+         * @brief Get the date the completion of a task was processed by DAGMan
+         *
+         * @param id: the dense task ID
+         * @return the date (negative if the task has not completed)
+         */
+        double TaskLifecycleTable::getCompletionDate(unsigned long id) const {
+            return this->completion_dates[id];
+        }
+
+        /**
+         * @brief Get whether a task has completed
+         *
+         * @param id: the dense task ID
+         * @return true if the task has completed
+         */
+        bool TaskLifecycleTable::isCompleted(unsigned long id) const {
+            return this->completion_dates[id] >= 0;
+        }
+
+        /**
+         * @brief Get the number of tasks in the table
+         * @return the number of tasks
+         */
+        unsigned long TaskLifecycleTable::getNumberOfTasks() const {
+            return this->completion_dates.size();
+        }
+
+        /**
+         * @brief Get the tasks that went through a lifecycle event, in date order (as the former simulation
+         *        output traces of task submission, scheduling, and completion timestamps)
+         *
+         * @param event: the lifecycle event
+         * @param workflow_index: the index of the workflow (tasks of released sub-workflows are left out)
+         * @return the event records, ordered by date (ties broken by dense ID)
+         */
+        std::vector<TaskLifecycleTable::Record>
+        TaskLifecycleTable::getTrace(Event event, const WorkflowIndex &workflow_index) const {
+            const std::vector<double> &dates = event == SUBMITTED ? this->submitted_dates
+                                                                  : event == SCHEDULED ? this->scheduled_dates
+                                                                                       : this->completion_dates;
+            std::vector<Record> trace;
+            for (unsigned long id = 0; id < dates.size(); id++) {
+                auto task = workflow_index.getTask(id);
+                if (dates[id] >= 0 && task) {
+                    trace.push_back({task, dates[id]});
+                }
+            }
+            std::stable_sort(trace.begin(), trace.end(), [](const Record &lhs, const Record &rhs) {
+                return lhs.date < rhs.date;
+            });
+            return trace;
+        }
+    }
+}
@@ -0,0 +1,82 @@
+/**
+ * Copyright (c) 2017-2021. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef PEGASUS_TASKLIFECYCLETABLE_H
+#define PEGASUS_TASKLIFECYCLETABLE_H
+
+#include <vector>
+
+namespace wrench {
+
+    class WorkflowTask;
+
+    namespace pegasus {
+
+        class WorkflowIndex;
+
+        /**
+         * @brief Lifecycle dates of the workflow tasks (submitted by DAGMan, scheduled on a HTCondor pool, and
+         *        completed), stored as one array per event and indexed by dense task ID. Dates of events that
+         *        did not happen (yet) are negative.
+         */
+        class TaskLifecycleTable {
+        public:
+            /** @brief Task lifecycle events */
+            enum Event {
+                SUBMITTED,
+                SCHEDULED,
+                COMPLETED
+            };
+
+            /**
+             * @brief A task lifecycle event, as formerly recorded in the simulation output by the
+             *        SimulationTimestampJobSubmitted, SimulationTimestampJobScheduled, and
+             *        SimulationTimestampJobCompletion timestamps
+             */
+            struct Record {
+                /** @brief The task */
+                WorkflowTask *task;
+                /** @brief The date of the event */
+                double date;
+            };
+
+            explicit TaskLifecycleTable(unsigned long num_tasks);
+
+            void resize(unsigned long num_tasks);
+
+            void recordSubmitted(unsigned long id);
+
+            void recordScheduled(unsigned long id);
+
+            void recordCompleted(unsigned long id);
+
+            double getSubmittedDate(unsigned long id) const;
+
+            double getScheduledDate(unsigned long id) const;
+
+            double getCompletionDate(unsigned long id) const;
+
+            bool isCompleted(unsigned long id) const;
+
+            unsigned long getNumberOfTasks() const;
+
+            std::vector<Record> getTrace(Event event, const WorkflowIndex &workflow_index) const;
+
+        private:
+            /** @brief Date each task was submitted by DAGMan */
+            std::vector<double> submitted_dates;
+            /** @brief Date each task was scheduled (submitted to a HTCondor pool) */
+            std::vector<double> scheduled_dates;
+            /** @brief Date each task completion was processed by DAGMan */
+            std::vector<double> completion_dates;
+        };
+    }
+}
+
+#endif //PEGASUS_TASKLIFECYCLETABLE_H
@@ -0,0 +1,96 @@
+/**
+ * Copyright (c) 2017-2021. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <nlohmann/json.hpp>
+#include <wrench-dev.h>
+
+#include "TaskTraceSink.h"
+
+#define TRACE_BUFFER_SIZE (1 << 20)
+
+namespace wrench {
+    namespace pegasus {
+
+        /**
+         * @brief Constructor
+         *
+         * @param filename: the trace file path (*.csv or *.jsonl)
+         * @param workflow_index: the index of the workflow being executed
+         *
+         * @throw std::invalid_argument
+         */
+        TaskTraceSink::TaskTraceSink(const std::string &filename, std::shared_ptr<WorkflowIndex> workflow_index) :
+                workflow_index(workflow_index), buffer(TRACE_BUFFER_SIZE) {
+            std::string extension = filename.substr(filename.find_last_of('.') + 1);
+            if (extension != "csv" && extension != "jsonl") {
+                throw std::invalid_argument("TaskTraceSink::TaskTraceSink(): Invalid trace file name " + filename +
+                                            " (should be *.csv or *.jsonl)");
+            }
+            this->jsonl = extension == "jsonl";
+
+            this->file.rdbuf()->pubsetbuf(this->buffer.data(), this->buffer.size());
+            this->file.open(filename);
+            if (not this->file) {
+                throw std::invalid_argument("TaskTraceSink::TaskTraceSink(): Unable to open trace file " + filename);
+            }
+            if (not this->jsonl) {
+                this->file << "task_id,category,level,host,submitted,scheduled,started,ended,completed\n";
+            }
+        }
+
+        /**
+         * @brief Destructor
+         */
+        TaskTraceSink::~TaskTraceSink() {
+            this->file.close();
+        }
+
+        /**
+         * @brief Write the lifecycle record of a completed task
+         *
+         * @param task: the completed task
+         * @param lifecycle_table: the lifecycle dates of the workflow tasks
+         */
+        void TaskTraceSink::notifyTaskCompleted(WorkflowTask *task, const TaskLifecycleTable &lifecycle_table) {
+            unsigned long id = this->workflow_index->getTaskIndex(task);
+            auto &categories = this->workflow_index->getCategories();
+            const std::string &category = categories.getCategoryName(categories.getTaskCategory(id));
+
+            if (this->jsonl) {
+                nlohmann::json record = {{"task_id",   task->getID()},
+                                         {"category",  category},
+                                         {"level",     this->workflow_index->getTopLevel(id)},
+                                         {"host",      task->getExecutionHost()},
+                                         {"submitted", lifecycle_table.getSubmittedDate(id)},
+                                         {"scheduled", lifecycle_table.getScheduledDate(id)},
+                                         {"started",   task->getStartDate()},
+                                         {"ended",     task->getEndDate()},
+                                         {"completed", lifecycle_table.getCompletionDate(id)}};
+                this->file << record.dump() << "\n";
+            } else {
+                this->file << task->getID() << "," <<
+                           category << "," <<
+                           this->workflow_index->getTopLevel(id) << "," <<
+                           task->getExecutionHost() << "," <<
+                           lifecycle_table.getSubmittedDate(id) << "," <<
+                           lifecycle_table.getScheduledDate(id) << "," <<
+                           task->getStartDate() << "," <<
+                           task->getEndDate() << "," <<
+                           lifecycle_table.getCompletionDate(id) << "\n";
+            }
+        }
+
+        /**
+         * @brief Flush buffered records to the trace file
+         */
+        void TaskTraceSink::flush() {
+            this->file.flush();
+        }
+    }
+}
@@ -0,0 +1,52 @@
+/**
+ * Copyright (c) 2017-2021. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef PEGASUS_TASKTRACESINK_H
+#define PEGASUS_TASKTRACESINK_H
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "TaskLifecycleTable.h"
+#include "WorkflowIndex.h"
+
+namespace wrench {
+    namespace pegasus {
+
+        /**
+         * @brief A sink that streams the lifecycle record of each task (submitted, scheduled, started, and
+         *        completed dates, level, and category) to a buffered CSV or JSONL file as soon as the task
+         *        completes. Nothing is kept in memory besides the output buffer.
+         */
+        class TaskTraceSink {
+        public:
+            TaskTraceSink(const std::string &filename, std::shared_ptr<WorkflowIndex> workflow_index);
+
+            ~TaskTraceSink();
+
+            void notifyTaskCompleted(WorkflowTask *task, const TaskLifecycleTable &lifecycle_table);
+
+            void flush();
+
+        private:
+            /** @brief The index of the workflow being executed */
+            std::shared_ptr<WorkflowIndex> workflow_index;
+            /** @brief Whether records are written as JSON lines (otherwise as CSV) */
+            bool jsonl;
+            /** @brief Output buffer */
+            std::vector<char> buffer;
+            /** @brief Output file */
+            std::ofstream file;
+        };
+    }
+}
+
+#endif //PEGASUS_TASKTRACESINK_H
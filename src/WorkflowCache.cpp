@@ -0,0 +1,365 @@
+/**
+ * Copyright (c) 2017-2021. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+#include "WorkflowCache.h"
+
+#define WORKFLOW_CACHE_MAGIC "WPC\0"
+#define WORKFLOW_CACHE_VERSION 3
+
+namespace wrench {
+    namespace pegasus {
+
+        /**
+         * @brief Get the nanoseconds of the modification date of a file (the seconds being st_mtime)
+         *
+         * @param file_stat: the file status
+         * @return the nanoseconds of the modification date
+         */
+        static int64_t getModificationNanoseconds(const struct stat &file_stat) {
+#ifdef __APPLE__
+            return file_stat.st_mtimespec.tv_nsec;
+#else
+            return file_stat.st_mtim.tv_nsec;
+#endif
+        }
+
+        /**
+         * @brief Add the product of two sizes to a total size, unless it overflows
+         *
+         * @param total: the total size
+         * @param count: the number of elements
+         * @param element_size: the size of an element
+         * @return false if the result overflows
+         */
+        static bool addSize(uint64_t &total, uint64_t count, uint64_t element_size) {
+            if (element_size != 0 && count > std::numeric_limits<uint64_t>::max() / element_size) {
+                return false;
+            }
+            uint64_t size = count * element_size;
+            if (total > std::numeric_limits<uint64_t>::max() - size) {
+                return false;
+            }
+            total += size;
+            return true;
+        }
+
+        /**
+         * @brief Get the path of the cache of a workflow file
+         *
+         * @param workflow_filename: the DAX or JSON workflow file path
+         * @return the cache file path (the workflow file path with a .wpc suffix)
+         */
+        std::string WorkflowCache::getCacheFilename(const std::string &workflow_filename) {
+            return workflow_filename + ".wpc";
+        }
+
+        /**
+         * @brief Get whether a cache file exists and matches the current version of its workflow file
+         *
+         * @param cache_filename: the cache file path
+         * @param workflow_filename: the DAX or JSON workflow file path
+         * @return true if the cache can be loaded instead of parsing the workflow file
+         */
+        bool WorkflowCache::isValid(const std::string &cache_filename, const std::string &workflow_filename) {
+            Header header;
+            struct stat source_stat;
+            if (not readHeader(cache_filename, header) || stat(workflow_filename.c_str(), &source_stat) != 0) {
+                return false;
+            }
+            return header.source_size == (uint64_t) source_stat.st_size &&
+                   header.source_mtime == (int64_t) source_stat.st_mtime &&
+                   header.source_mtime_nsec == getModificationNanoseconds(source_stat);
+        }
+
+        /**
+         * @brief Write the cache of a workflow
+         *
+         * @param workflow: the workflow, as parsed from the workflow file
+         * @param cache_filename: the cache file path
+         * @param workflow_filename: the DAX or JSON workflow file path
+         * @param transformations: the transformations of the workflow tasks, indexed by task ID
+         *
+         * @throw std::runtime_error
+         */
+        void WorkflowCache::write(Workflow *workflow, const std::string &cache_filename,
+                                  const std::string &workflow_filename,
+                                  const TaskCategoryRegistry::TransformationMap &transformations) {
+            struct stat source_stat;
+            if (stat(workflow_filename.c_str(), &source_stat) != 0) {
+                throw std::runtime_error("WorkflowCache::write(): Unable to stat workflow file " + workflow_filename);
+            }
+
+            auto files = workflow->getFiles();
+            auto tasks = workflow->getTasks();
+            std::map<WorkflowFile *, uint64_t> file_indices;
+            std::map<WorkflowTask *, uint64_t> task_indices;
+            for (auto file : files) {
+                file_indices.insert(std::make_pair(file, file_indices.size()));
+            }
+            for (auto task : tasks) {
+                task_indices.insert(std::make_pair(task, task_indices.size()));
+            }
+
+            // string table: file IDs, then task IDs and transformations
+            std::vector<uint64_t> string_offsets(1, 0);
+            std::string strings;
+            std::vector<FileRecord> file_records;
+            for (auto file : files) {
+                file_records.push_back({string_offsets.size() - 1, file->getSize()});
+                strings += file->getID();
+                string_offsets.push_back(strings.size());
+            }
+
+            std::vector<TaskRecord> task_records;
+            std::vector<uint64_t> input_offsets(1, 0), inputs;
+            std::vector<uint64_t> output_offsets(1, 0), outputs;
+            std::vector<uint64_t> parent_offsets(1, 0), parents;
+            for (auto task : tasks) {
+                task_records.push_back({string_offsets.size() - 1, task->getFlops(), task->getMinNumCores(),
+                                        task->getMaxNumCores(), task->getMemoryRequirement(),
+                                        task->getAverageCPU(), task->getBytesRead(), task->getBytesWritten(),
+                                        task->getPriority(), string_offsets.size()});
+                strings += task->getID();
+                string_offsets.push_back(strings.size());
+                auto transformation = transformations.find(task->getID());
+                if (transformation != transformations.end()) {
+                    strings += transformation->second;
+                }
+                string_offsets.push_back(strings.size());
+
+                for (auto file : task->getInputFiles()) {
+                    inputs.push_back(file_indices.at(file));
+                }
+                input_offsets.push_back(inputs.size());
+                for (auto file : task->getOutputFiles()) {
+                    outputs.push_back(file_indices.at(file));
+                }
+                output_offsets.push_back(outputs.size());
+                for (auto parent : workflow->getTaskParents(task)) {
+                    parents.push_back(task_indices.at(parent));
+                }
+                parent_offsets.push_back(parents.size());
+            }
+
+            Header header;
+            std::memcpy(header.magic, WORKFLOW_CACHE_MAGIC, sizeof(header.magic));
+            header.version = WORKFLOW_CACHE_VERSION;
+            header.source_size = source_stat.st_size;
+            header.source_mtime = source_stat.st_mtime;
+            header.source_mtime_nsec = getModificationNanoseconds(source_stat);
+            header.num_files = file_records.size();
+            header.num_tasks = task_records.size();
+            header.num_inputs = inputs.size();
+            header.num_outputs = outputs.size();
+            header.num_parents = parents.size();
+            header.num_strings = string_offsets.size() - 1;
+            header.string_bytes = strings.size();
+
+            // written to a temporary file first, so that concurrent runs never map a partial cache
+            std::string tmp_filename = cache_filename + ".tmp." + std::to_string(getpid());
+            std::ofstream file(tmp_filename, std::ios::binary);
+            if (not file) {
+                throw std::runtime_error("WorkflowCache::write(): Unable to write cache file " + tmp_filename);
+            }
+            auto write_array = [&file](const void *data, size_t size) {
+                file.write((const char *) data, size);
+            };
+            write_array(&header, sizeof(header));
+            write_array(file_records.data(), file_records.size() * sizeof(FileRecord));
+            write_array(task_records.data(), task_records.size() * sizeof(TaskRecord));
+            write_array(input_offsets.data(), input_offsets.size() * sizeof(uint64_t));
+            write_array(inputs.data(), inputs.size() * sizeof(uint64_t));
+            write_array(output_offsets.data(), output_offsets.size() * sizeof(uint64_t));
+            write_array(outputs.data(), outputs.size() * sizeof(uint64_t));
+            write_array(parent_offsets.data(), parent_offsets.size() * sizeof(uint64_t));
+            write_array(parents.data(), parents.size() * sizeof(uint64_t));
+            write_array(string_offsets.data(), string_offsets.size() * sizeof(uint64_t));
+            write_array(strings.data(), strings.size());
+            file.close();
+
+            if (not file || std::rename(tmp_filename.c_str(), cache_filename.c_str()) != 0) {
+                std::remove(tmp_filename.c_str());
+                throw std::runtime_error("WorkflowCache::write(): Unable to write cache file " + cache_filename);
+            }
+        }
+
+        /**
+         * @brief Load a workflow from a cache file
+         *
+         * @param cache_filename: the cache file path
+         * @param transformations: if not null, the transformations of the workflow tasks are added to it
+         * @return the workflow (owned by the caller)
+         *
+         * @throw std::invalid_argument
+         */
+        Workflow *WorkflowCache::load(const std::string &cache_filename,
+                                      TaskCategoryRegistry::TransformationMap *transformations) {
+            int fd = open(cache_filename.c_str(), O_RDONLY);
+            if (fd < 0) {
+                throw std::invalid_argument("WorkflowCache::load(): Unable to open cache file " + cache_filename);
+            }
+            struct stat cache_stat;
+            if (fstat(fd, &cache_stat) != 0 || (uint64_t) cache_stat.st_size < sizeof(Header)) {
+                close(fd);
+                throw std::invalid_argument("WorkflowCache::load(): Invalid cache file " + cache_filename);
+            }
+            void *data = mmap(nullptr, cache_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            close(fd);
+            if (data == MAP_FAILED) {
+                throw std::invalid_argument("WorkflowCache::load(): Unable to map cache file " + cache_filename);
+            }
+
+            auto header = (const Header *) data;
+            uint64_t expected_size;
+            if (std::memcmp(header->magic, WORKFLOW_CACHE_MAGIC, sizeof(header->magic)) != 0 ||
+                header->version != WORKFLOW_CACHE_VERSION || not getSize(*header, expected_size) ||
+                expected_size != (uint64_t) cache_stat.st_size) {
+                munmap(data, cache_stat.st_size);
+                throw std::invalid_argument("WorkflowCache::load(): Invalid cache file " + cache_filename);
+            }
+
+            // sections
+            auto file_records = (const FileRecord *) (header + 1);
+            auto task_records = (const TaskRecord *) (file_records + header->num_files);
+            auto input_offsets = (const uint64_t *) (task_records + header->num_tasks);
+            auto inputs = input_offsets + header->num_tasks + 1;
+            auto output_offsets = inputs + header->num_inputs;
+            auto outputs = output_offsets + header->num_tasks + 1;
+            auto parent_offsets = outputs + header->num_outputs;
+            auto parents = parent_offsets + header->num_tasks + 1;
+            auto string_offsets = parents + header->num_parents;
+            auto strings = (const char *) (string_offsets + header->num_strings + 1);
+
+            auto get_string = [&](uint64_t index) {
+                if (index >= header->num_strings || string_offsets[index] > string_offsets[index + 1] ||
+                    string_offsets[index + 1] > header->string_bytes) {
+                    throw std::invalid_argument("WorkflowCache::load(): Invalid cache file " + cache_filename);
+                }
+                return std::string(strings + string_offsets[index], string_offsets[index + 1] - string_offsets[index]);
+            };
+            auto check_range = [&](const uint64_t *offsets, uint64_t task, uint64_t num_values, uint64_t max_value,
+                                   const uint64_t *values) {
+                if (offsets[task] > offsets[task + 1] || offsets[task + 1] > num_values) {
+                    throw std::invalid_argument("WorkflowCache::load(): Invalid cache file " + cache_filename);
+                }
+                for (uint64_t i = offsets[task]; i < offsets[task + 1]; i++) {
+                    if (values[i] >= max_value) {
+                        throw std::invalid_argument("WorkflowCache::load(): Invalid cache file " + cache_filename);
+                    }
+                }
+            };
+
+            auto workflow = new Workflow();
+            try {
+                std::vector<WorkflowFile *> workflow_files;
+                workflow_files.reserve(header->num_files);
+                for (uint64_t i = 0; i < header->num_files; i++) {
+                    workflow_files.push_back(workflow->addFile(get_string(file_records[i].id), file_records[i].size));
+                }
+
+                std::vector<WorkflowTask *> workflow_tasks;
+                workflow_tasks.reserve(header->num_tasks);
+                for (uint64_t i = 0; i < header->num_tasks; i++) {
+                    auto &record = task_records[i];
+                    auto task = workflow->addTask(get_string(record.id), record.flops, record.min_num_cores,
+                                                  record.max_num_cores, record.memory_requirement);
+                    std::string transformation = get_string(record.transformation);
+                    if (transformations && not transformation.empty()) {
+                        (*transformations)[task->getID()] = transformation;
+                    }
+                    task->setAverageCPU(record.average_cpu);
+                    task->setBytesRead(record.bytes_read);
+                    task->setBytesWritten(record.bytes_written);
+                    task->setPriority(record.priority);
+                    workflow_tasks.push_back(task);
+                }
+
+                for (uint64_t i = 0; i < header->num_tasks; i++) {
+                    check_range(input_offsets, i, header->num_inputs, header->num_files, inputs);
+                    for (uint64_t j = input_offsets[i]; j < input_offsets[i + 1]; j++) {
+                        workflow_tasks[i]->addInputFile(workflow_files[inputs[j]]);
+                    }
+                    check_range(output_offsets, i, header->num_outputs, header->num_files, outputs);
+                    for (uint64_t j = output_offsets[i]; j < output_offsets[i + 1]; j++) {
+                        workflow_tasks[i]->addOutputFile(workflow_files[outputs[j]]);
+                    }
+                }
+                for (uint64_t i = 0; i < header->num_tasks; i++) {
+                    check_range(parent_offsets, i, header->num_parents, header->num_tasks, parents);
+                    for (uint64_t j = parent_offsets[i]; j < parent_offsets[i + 1]; j++) {
+                        workflow->addControlDependency(workflow_tasks[parents[j]], workflow_tasks[i]);
+                    }
+                }
+            } catch (std::invalid_argument &e) {
+                munmap(data, cache_stat.st_size);
+                delete workflow;
+                throw;
+            }
+
+            munmap(data, cache_stat.st_size);
+            return workflow;
+        }
+
+        /**
+         * @brief Get the expected size of a cache file. The counts come from an untrusted header, so every
+         *        product and sum is checked for overflow.
+         *
+         * @param header: the cache file header
+         * @param size: the size in bytes
+         * @return false if the size overflows (i.e., the header is invalid)
+         */
+        bool WorkflowCache::getSize(const Header &header, uint64_t &size) {
+            size = sizeof(Header);
+            if (header.num_tasks == std::numeric_limits<uint64_t>::max() ||
+                header.num_strings == std::numeric_limits<uint64_t>::max()) {
+                return false;
+            }
+            // three CSR offset arrays of num_tasks + 1 values
+            for (int i = 0; i < 3; i++) {
+                if (not addSize(size, header.num_tasks + 1, sizeof(uint64_t))) {
+                    return false;
+                }
+            }
+            return addSize(size, header.num_files, sizeof(FileRecord)) &&
+                   addSize(size, header.num_tasks, sizeof(TaskRecord)) &&
+                   addSize(size, header.num_inputs, sizeof(uint64_t)) &&
+                   addSize(size, header.num_outputs, sizeof(uint64_t)) &&
+                   addSize(size, header.num_parents, sizeof(uint64_t)) &&
+                   addSize(size, header.num_strings + 1, sizeof(uint64_t)) &&
+                   addSize(size, header.string_bytes, 1);
+        }
+
+        /**
+         * @brief Read the header of a cache file
+         *
+         * @param cache_filename: the cache file path
+         * @param header: the header read
+         * @return true if the file exists and has a header of the current format version
+         */
+        bool WorkflowCache::readHeader(const std::string &cache_filename, Header &header) {
+            std::ifstream file(cache_filename, std::ios::binary);
+            if (not file.read((char *) &header, sizeof(header))) {
+                return false;
+            }
+            return std::memcmp(header.magic, WORKFLOW_CACHE_MAGIC, sizeof(header.magic)) == 0 &&
+                   header.version == WORKFLOW_CACHE_VERSION;
+        }
+    }
+}
@@ -0,0 +1,98 @@
+/**
+ * Copyright (c) 2017-2021. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef PEGASUS_WORKFLOWCACHE_H
+#define PEGASUS_WORKFLOWCACHE_H
+
+#include <cstdint>
+#include <string>
+#include <wrench-dev.h>
+
+#include "TaskCategoryRegistry.h"
+
+namespace wrench {
+    namespace pegasus {
+
+        /**
+         * @brief A binary pre-parsed workflow (*.wpc) stored next to its DAX or JSON source file, memory-mapped at
+         *        load. The file holds a header (with the size and modification date, to the nanosecond, of the
+         *        source file, so that stale caches are ignored), a file array, a task array, CSR arrays of task input files, output
+         *        files, and parents, and a string table holding task and file IDs and task transformations.
+         */
+        class WorkflowCache {
+        public:
+            static std::string getCacheFilename(const std::string &workflow_filename);
+
+            static bool isValid(const std::string &cache_filename, const std::string &workflow_filename);
+
+            static void write(Workflow *workflow, const std::string &cache_filename,
+                              const std::string &workflow_filename,
+                              const TaskCategoryRegistry::TransformationMap &transformations = {});
+
+            static Workflow *load(const std::string &cache_filename,
+                                  TaskCategoryRegistry::TransformationMap *transformations = nullptr);
+
+        private:
+            /**
+             * @brief File header (all sections follow in order, each 8-byte aligned)
+             */
+            struct Header {
+                /** @brief Magic number and format version */
+                char magic[4];
+                uint32_t version;
+                /** @brief Size and modification date (seconds and nanoseconds) of the source file */
+                uint64_t source_size;
+                int64_t source_mtime;
+                int64_t source_mtime_nsec;
+                /** @brief Number of files, tasks, and CSR values */
+                uint64_t num_files;
+                uint64_t num_tasks;
+                uint64_t num_inputs;
+                uint64_t num_outputs;
+                uint64_t num_parents;
+                /** @brief Number of strings and total size of the string characters */
+                uint64_t num_strings;
+                uint64_t string_bytes;
+            };
+
+            /**
+             * @brief A workflow file
+             */
+            struct FileRecord {
+                /** @brief Index of the file ID in the string table */
+                uint64_t id;
+                double size;
+            };
+
+            /**
+             * @brief A workflow task
+             */
+            struct TaskRecord {
+                /** @brief Index of the task ID in the string table */
+                uint64_t id;
+                double flops;
+                uint64_t min_num_cores;
+                uint64_t max_num_cores;
+                double memory_requirement;
+                double average_cpu;
+                uint64_t bytes_read;
+                uint64_t bytes_written;
+                int64_t priority;
+                /** @brief Index of the task transformation in the string table (empty if none) */
+                uint64_t transformation;
+            };
+
+            static bool getSize(const Header &header, uint64_t &size);
+
+            static bool readHeader(const std::string &cache_filename, Header &header);
+        };
+    }
+}
+
+#endif //PEGASUS_WORKFLOWCACHE_H
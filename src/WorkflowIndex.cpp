@@ -0,0 +1,249 @@
+/**
+ * Copyright (c) 2017-2021. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include "WorkflowIndex.h"
+
+XBT_LOG_NEW_DEFAULT_CATEGORY(WorkflowIndex, "Log category for WorkflowIndex");
+
+namespace wrench {
+    namespace pegasus {
+
+        /**
+         * @brief Constructor, which builds the index from a workflow
+         *
+         * @param workflow: the workflow to be indexed
+         * @param transformations: the transformations of the workflow tasks, which are their categories (tasks
+         *                         with no transformation are categorized by their ID prefix)
+         *
+         * @throw std::invalid_argument
+         */
+        WorkflowIndex::WorkflowIndex(Workflow *workflow,
+                                     const TaskCategoryRegistry::TransformationMap &transformations) {
+            if (workflow == nullptr) {
+                throw std::invalid_argument("WorkflowIndex::WorkflowIndex(): invalid workflow");
+            }
+            this->categories.addTransformations(transformations);
+
+            this->parent_offsets.push_back(0);
+            this->child_offsets.push_back(0);
+            this->index(workflow, workflow->getTasks(), 0, 0);
+
+            WRENCH_INFO("Indexed %lu tasks, %lu dependencies, and %u task categories", this->tasks.size(),
+                        this->parents.size(), this->categories.getNumberOfCategories());
+        }
+
+        /**
+         * @brief Append the tasks of an expanded sub-workflow to the index. Their levels and priorities are
+         *        relative to the sub-workflow node, and only their dependencies to one another are indexed
+         *        (their other parents are ancestors of the node, which have completed).
+         *
+         * @param workflow: the workflow the tasks have been added to
+         * @param new_tasks: the tasks of the sub-workflow
+         * @param node: the dense ID of the sub-workflow node
+         * @param transformations: the transformations of the sub-workflow tasks
+         * @return the dense ID of the first appended task (the others follow contiguously)
+         *
+         * @throw std::invalid_argument
+         */
+        unsigned long WorkflowIndex::append(Workflow *workflow, const std::vector<WorkflowTask *> &new_tasks,
+                                            unsigned long node,
+                                            const TaskCategoryRegistry::TransformationMap &transformations) {
+            unsigned long first = this->tasks.size();
+            this->categories.addTransformations(transformations);
+            this->index(workflow, new_tasks, this->top_levels[node] + 1, this->priorities[node]);
+            return first;
+        }
+
+        /**
+         * @brief Release a completed task (e.g., of an expanded sub-workflow) that is about to be removed from the
+         *        workflow. Its dense ID remains valid, but no longer maps to a task.
+         *
+         * @param id: a task dense ID
+         */
+        void WorkflowIndex::release(unsigned long id) {
+            this->task_ids.erase(this->tasks[id]);
+            this->tasks[id] = nullptr;
+        }
+
+        /**
+         * @brief Index tasks added after the already indexed ones: assign dense IDs, register categories, append
+         *        the CSR arrays, and compute top levels and inherited priorities in topological order
+         *
+         * @param workflow: the workflow
+         * @param new_tasks: the tasks to be indexed
+         * @param base_level: the top level of the new entry tasks
+         * @param base_priority: the priority inherited by all new tasks
+         *
+         * @throw std::invalid_argument
+         */
+        void WorkflowIndex::index(Workflow *workflow, const std::vector<WorkflowTask *> &new_tasks,
+                                  unsigned long base_level, long base_priority) {
+            unsigned long first = this->tasks.size();
+            unsigned long num_tasks = first + new_tasks.size();
+            this->tasks.insert(this->tasks.end(), new_tasks.begin(), new_tasks.end());
+            this->task_ids.reserve(num_tasks);
+            for (unsigned long id = first; id < num_tasks; id++) {
+                this->task_ids.insert(std::make_pair(this->tasks[id], id));
+                this->categories.addTask(this->tasks[id]->getID());
+            }
+
+            // parents (CSR), among the new tasks
+            unsigned long first_parent = this->parents.size();
+            for (unsigned long id = first; id < num_tasks; id++) {
+                for (auto parent : workflow->getTaskParents(this->tasks[id])) {
+                    auto it = this->task_ids.find(parent);
+                    if (it != this->task_ids.end() && it->second >= first) {
+                        this->parents.push_back(it->second);
+                    }
+                }
+                this->parent_offsets.push_back(this->parents.size());
+            }
+
+            // children (CSR), derived from the parents arrays
+            std::vector<unsigned long> child_counts(new_tasks.size() + 1, 0);
+            for (unsigned long i = first_parent; i < this->parents.size(); i++) {
+                child_counts[this->parents[i] - first + 1]++;
+            }
+            unsigned long first_child = this->children.size();
+            for (unsigned long id = first; id < num_tasks; id++) {
+                child_counts[id - first + 1] += child_counts[id - first];
+                this->child_offsets.push_back(first_child + child_counts[id - first + 1]);
+            }
+            this->children.resize(first_child + this->parents.size() - first_parent);
+            std::vector<unsigned long> next_child(this->child_offsets.begin() + first, this->child_offsets.end() - 1);
+            for (unsigned long id = first; id < num_tasks; id++) {
+                for (auto parent : this->getParents(id)) {
+                    this->children[next_child[parent - first]++] = id;
+                }
+            }
+
+            // top levels and inherited priorities in topological order
+            this->top_levels.resize(num_tasks, base_level);
+            this->priorities.resize(num_tasks);
+            for (unsigned long id = first; id < num_tasks; id++) {
+                this->priorities[id] = std::max(this->tasks[id]->getPriority(), base_priority);
+            }
+
+            std::vector<unsigned long> pending_parents(new_tasks.size());
+            unsigned long first_sorted = this->topological_order.size();
+            this->topological_order.reserve(num_tasks);
+            for (unsigned long id = first; id < num_tasks; id++) {
+                pending_parents[id - first] = this->getParents(id).size();
+                if (pending_parents[id - first] == 0) {
+                    this->topological_order.push_back(id);
+                }
+            }
+            for (unsigned long i = first_sorted; i < this->topological_order.size(); i++) {
+                unsigned long id = this->topological_order[i];
+                for (auto child : this->getChildren(id)) {
+                    this->top_levels[child] = std::max(this->top_levels[child], this->top_levels[id] + 1);
+                    this->priorities[child] = std::max(this->priorities[child], this->priorities[id]);
+                    if (--pending_parents[child - first] == 0) {
+                        this->topological_order.push_back(child);
+                    }
+                }
+            }
+            if (this->topological_order.size() != num_tasks) {
+                throw std::invalid_argument("WorkflowIndex::index(): workflow is not a DAG");
+            }
+        }
+
+        /**
+         * @brief Get the number of indexed tasks
+         * @return number of tasks
+         */
+        unsigned long WorkflowIndex::getNumberOfTasks() const {
+            return this->tasks.size();
+        }
+
+        /**
+         * @brief Get the dense ID of a task
+         *
+         * @param task: a workflow task
+         * @return the task dense ID
+         *
+         * @throw std::invalid_argument
+         */
+        unsigned long WorkflowIndex::getTaskIndex(const WorkflowTask *task) const {
+            auto it = this->task_ids.find(task);
+            if (it == this->task_ids.end()) {
+                throw std::invalid_argument("WorkflowIndex::getTaskIndex(): unknown task " + task->getID());
+            }
+            return it->second;
+        }
+
+        /**
+         * @brief Get a task from its dense ID
+         *
+         * @param id: a task dense ID
+         * @return the workflow task (nullptr if the task has been released)
+         */
+        WorkflowTask *WorkflowIndex::getTask(unsigned long id) const {
+            return this->tasks[id];
+        }
+
+        /**
+         * @brief Get the dense IDs of the parents of a task
+         *
+         * @param id: a task dense ID
+         * @return a range of parent IDs
+         */
+        WorkflowIndex::Range WorkflowIndex::getParents(unsigned long id) const {
+            const unsigned long *base = this->parents.data();
+            return {base + this->parent_offsets[id], base + this->parent_offsets[id + 1]};
+        }
+
+        /**
+         * @brief Get the dense IDs of the children of a task
+         *
+         * @param id: a task dense ID
+         * @return a range of child IDs
+         */
+        WorkflowIndex::Range WorkflowIndex::getChildren(unsigned long id) const {
+            const unsigned long *base = this->children.data();
+            return {base + this->child_offsets[id], base + this->child_offsets[id + 1]};
+        }
+
+        /**
+         * @brief Get the top level of a task (0 for entry tasks)
+         *
+         * @param id: a task dense ID
+         * @return the task top level
+         */
+        unsigned long WorkflowIndex::getTopLevel(unsigned long id) const {
+            return this->top_levels[id];
+        }
+
+        /**
+         * @brief Get the priority of a task, i.e., the highest priority among the task and its ancestors
+         *
+         * @param id: a task dense ID
+         * @return the task priority
+         */
+        long WorkflowIndex::getPriority(unsigned long id) const {
+            return this->priorities[id];
+        }
+
+        /**
+         * @brief Get the dense IDs of all tasks in topological order
+         * @return a vector of dense IDs
+         */
+        const std::vector<unsigned long> &WorkflowIndex::getTopologicalOrder() const {
+            return this->topological_order;
+        }
+
+        /**
+         * @brief Get the task category registry
+         * @return the task category registry
+         */
+        const TaskCategoryRegistry &WorkflowIndex::getCategories() const {
+            return this->categories;
+        }
+    }
+}
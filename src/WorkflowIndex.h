@@ -0,0 +1,98 @@
+/**
+ * Copyright (c) 2017-2021. The WRENCH Team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef PEGASUS_WORKFLOWINDEX_H
+#define PEGASUS_WORKFLOWINDEX_H
+
+#include <unordered_map>
+#include <vector>
+#include <wrench-dev.h>
+
+#include "TaskCategoryRegistry.h"
+
+namespace wrench {
+    namespace pegasus {
+
+        /**
+         * @brief A compact index of the workflow DAG built once after parsing. Tasks are identified by dense IDs
+         *        (0..n-1, in workflow task order), parents and children are stored in CSR arrays, and top levels
+         *        and DAGMan-inherited priorities are precomputed in a single topological pass. Task categories
+         *        are also registered when the index is built. The tasks of expanded sub-workflows are appended
+         *        (with new dense IDs) and released once completed; dense IDs are never reused.
+         */
+        class WorkflowIndex {
+        public:
+            /**
+             * @brief A contiguous range of dense task IDs
+             */
+            struct Range {
+                const unsigned long *first;
+                const unsigned long *last;
+
+                const unsigned long *begin() const { return first; }
+
+                const unsigned long *end() const { return last; }
+
+                unsigned long size() const { return last - first; }
+            };
+
+            explicit WorkflowIndex(Workflow *workflow,
+                                   const TaskCategoryRegistry::TransformationMap &transformations = {});
+
+            unsigned long append(Workflow *workflow, const std::vector<WorkflowTask *> &new_tasks,
+                                 unsigned long node,
+                                 const TaskCategoryRegistry::TransformationMap &transformations = {});
+
+            void release(unsigned long id);
+
+            unsigned long getNumberOfTasks() const;
+
+            unsigned long getTaskIndex(const WorkflowTask *task) const;
+
+            WorkflowTask *getTask(unsigned long id) const;
+
+            Range getParents(unsigned long id) const;
+
+            Range getChildren(unsigned long id) const;
+
+            unsigned long getTopLevel(unsigned long id) const;
+
+            long getPriority(unsigned long id) const;
+
+            const std::vector<unsigned long> &getTopologicalOrder() const;
+
+            const TaskCategoryRegistry &getCategories() const;
+
+        private:
+            void index(Workflow *workflow, const std::vector<WorkflowTask *> &new_tasks, unsigned long base_level,
+                       long base_priority);
+
+            /** @brief Tasks indexed by dense ID (nullptr for released tasks) */
+            std::vector<WorkflowTask *> tasks;
+            /** @brief Dense ID of each task */
+            std::unordered_map<const WorkflowTask *, unsigned long> task_ids;
+            /** @brief CSR offsets and values for the task parents */
+            std::vector<unsigned long> parent_offsets;
+            std::vector<unsigned long> parents;
+            /** @brief CSR offsets and values for the task children */
+            std::vector<unsigned long> child_offsets;
+            std::vector<unsigned long> children;
+            /** @brief Top level of each task */
+            std::vector<unsigned long> top_levels;
+            /** @brief Priority of each task, inherited from parents according to DAGMan rules */
+            std::vector<long> priorities;
+            /** @brief Dense IDs in topological order */
+            std::vector<unsigned long> topological_order;
+            /** @brief Task categories */
+            TaskCategoryRegistry categories;
+        };
+    }
+}
+
+#endif //PEGASUS_WORKFLOWINDEX_H
@@ -0,0 +1,272 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2017-2021. The WRENCH Team.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+
+import argparse
+import datetime
+import fnmatch
+import glob
+import json
+import logging
+import os
+import platform
+import subprocess
+import tempfile
+import time
+
+logger = logging.getLogger(__name__)
+
+# metrics compared against the baseline, and whether higher values are better
+METRICS = {
+    'wall_time': False,
+    'peak_rss': False,
+    'events_per_second': True
+}
+
+
+def _configure_logging(debug):
+    """
+    Configure the application's logging.
+    :param debug: whether debugging is enabled
+    """
+    if debug:
+        logger.setLevel(logging.DEBUG)
+    else:
+        logger.setLevel(logging.INFO)
+
+    ch = logging.StreamHandler()
+    ch.setLevel(logging.DEBUG)
+    formatter = logging.Formatter('%(asctime)s [%(levelname)s] %(message)s')
+    ch.setFormatter(formatter)
+    logger.addHandler(ch)
+
+
+def _get_scenarios(examples_dir):
+    """
+    List the benchmark scenarios: the montage scalability workloads on the aws-montage-128 platform, and the
+    workflowhub synthetic traces on the chameleon platform.
+    :param examples_dir: the examples directory
+    :return: a list of scenarios (name, platform, workflow, and config files, and expected number of task
+             categories if known)
+    """
+    scenarios = []
+    # the montage DAX jobs have 9 transformations (mProjectPP, mDiffFit, mConcatFit, mBgModel, mBackground,
+    # mImgTbl, mAdd, mShrink, and mJPEG), which are their task categories
+    suites = [
+        ('scalability', os.path.join(examples_dir, 'evaluation', 'scalability'), 'montage-*.xml',
+         'aws-montage-128.xml', 'aws-montage-properties.json', 9),
+        ('workflowhub', os.path.join(examples_dir, 'workflowhub'), os.path.join('synthetic-traces', '*.json'),
+         'chameleon.xml', 'chameleon-properties.json', None)
+    ]
+    for suite, suite_dir, pattern, platform_file, config_file, categories in suites:
+        for workflow_file in sorted(glob.glob(os.path.join(suite_dir, pattern))):
+            scenarios.append({
+                'name': suite + '/' + os.path.splitext(os.path.basename(workflow_file))[0],
+                'platform': os.path.join(suite_dir, platform_file),
+                'workflow': workflow_file,
+                'config': os.path.join(suite_dir, config_file),
+                'categories': categories
+            })
+    return scenarios
+
+
+def _run_scenario(simulator, scenario, simulator_args):
+    """
+    Run a scenario and measure the simulator wall-clock time, peak RSS, and throughput. A scenario whose
+    number of task categories is not the expected one fails.
+    :param simulator: path to the wrench-pegasus-run executable
+    :param scenario: the scenario
+    :param simulator_args: additional simulator arguments
+    :return: the scenario measurements
+    """
+    fd, summary_file = tempfile.mkstemp(suffix='.json')
+    os.close(fd)
+    cmd = [simulator, scenario['platform'], scenario['workflow'], scenario['config'],
+           '--summary=' + summary_file] + simulator_args
+    logger.debug('Running: %s' % ' '.join(cmd))
+
+    try:
+        start = time.time()
+        proc = subprocess.Popen(cmd, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+        # wait4 provides the resource usage of this child only
+        _, status, rusage = os.wait4(proc.pid, 0)
+        wall_time = time.time() - start
+        proc.returncode = status
+
+        result = {
+            'exit_code': os.WEXITSTATUS(status) if os.WIFEXITED(status) else -os.WTERMSIG(status),
+            'wall_time': wall_time,
+            # kilobytes on Linux
+            'peak_rss': rusage.ru_maxrss
+        }
+        if result['exit_code'] == 0 and os.path.getsize(summary_file) == 0:
+            # the simulation was aborted before writing its summary
+            result['exit_code'] = 1
+        if result['exit_code'] == 0:
+            with open(summary_file) as f:
+                summary = json.load(f)
+            result['makespan'] = summary['makespan']
+            result['completed'] = summary['completed']
+            result['events'] = summary['events']
+            result['categories'] = summary['categories']
+            result['events_per_second'] = summary['events'] / wall_time if wall_time > 0 else 0
+            if scenario['categories'] is not None and result['categories'] != scenario['categories']:
+                logger.error('%s: %d task categories (expected %d)' % (scenario['name'], result['categories'],
+                                                                      scenario['categories']))
+                result['exit_code'] = 1
+        return result
+    finally:
+        os.remove(summary_file)
+
+
+def _merge_repetitions(results):
+    """
+    Merge the measurements of several runs of a scenario: the best wall-clock time and throughput, and the
+    largest peak RSS, are kept.
+    :param results: the measurements of each run
+    :return: the merged measurements
+    """
+    merged = dict(results[0])
+    for result in results[1:]:
+        if result['exit_code'] != 0:
+            return result
+        merged['wall_time'] = min(merged['wall_time'], result['wall_time'])
+        merged['peak_rss'] = max(merged['peak_rss'], result['peak_rss'])
+        merged['events_per_second'] = max(merged['events_per_second'], result['events_per_second'])
+    return merged
+
+
+def _compare(results, baseline, tolerance, makespan_tolerance):
+    """
+    Compare measurements against a baseline.
+    :param results: the measurements, indexed by scenario name
+    :param baseline: the baseline measurements, indexed by scenario name
+    :param tolerance: the relative degradation above which a metric is a regression
+    :param makespan_tolerance: the relative difference above which a makespan has changed
+    :return: the comparison per scenario, and the list of regressions
+    """
+    comparison = {}
+    regressions = []
+    for name, result in results.items():
+        if result['exit_code'] != 0:
+            regressions.append('%s: failed (exit code %d)' % (name, result['exit_code']))
+            continue
+        if name not in baseline:
+            comparison[name] = 'new'
+            continue
+        reference = baseline[name]
+        comparison[name] = {}
+        for metric, higher_is_better in METRICS.items():
+            if reference.get(metric, 0) <= 0:
+                continue
+            ratio = result[metric] / reference[metric]
+            regression = ratio < 1 - tolerance if higher_is_better else ratio > 1 + tolerance
+            comparison[name][metric] = {'baseline': reference[metric], 'current': result[metric],
+                                        'ratio': ratio, 'regression': regression}
+            if regression:
+                regressions.append('%s: %s %.3g -> %.3g (x%.2f)' % (name, metric, reference[metric],
+                                                                   result[metric], ratio))
+
+        # a different makespan means that the simulated behavior has changed
+        difference = abs(result['makespan'] - reference['makespan']) / max(reference['makespan'], 1e-9)
+        comparison[name]['makespan'] = {'baseline': reference['makespan'], 'current': result['makespan'],
+                                        'ratio': result['makespan'] / max(reference['makespan'], 1e-9),
+                                        'regression': difference > makespan_tolerance}
+        if difference > makespan_tolerance:
+            regressions.append('%s: makespan %.6g -> %.6g' % (name, reference['makespan'], result['makespan']))
+    return comparison, regressions
+
+
+def main():
+    default_examples_dir = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'examples')
+    default_baseline = os.path.join(os.path.dirname(os.path.abspath(__file__)), 'bench-baseline.json')
+
+    parser = argparse.ArgumentParser(description='Benchmark the simulator over the scalability workloads.')
+    parser.add_argument('simulator', metavar='SIMULATOR', help='Path to the wrench-pegasus-run executable')
+    parser.add_argument('-e', '--examples', dest='examples_dir', action='store', default=default_examples_dir,
+                        help='Examples directory')
+    parser.add_argument('-b', '--baseline', dest='baseline', action='store', default=default_baseline,
+                        help='Baseline file')
+    parser.add_argument('-o', dest='output', action='store', default='bench-results.json',
+                        help='Output filename')
+    parser.add_argument('-f', '--filter', dest='filter', action='store', default='*',
+                        help='Pattern of the scenario names to run (e.g., "scalability/montage-1000-*")')
+    parser.add_argument('-r', '--repetitions', dest='repetitions', action='store', type=int, default=1,
+                        help='Number of runs per scenario')
+    parser.add_argument('-t', '--tolerance', dest='tolerance', action='store', type=float, default=0.1,
+                        help='Relative degradation of a metric reported as a regression')
+    parser.add_argument('-m', '--makespan-tolerance', dest='makespan_tolerance', action='store', type=float,
+                        default=1e-6, help='Relative makespan difference reported as a regression')
+    parser.add_argument('-u', '--update-baseline', dest='update_baseline', action='store_true',
+                        help='Write the measurements to the baseline file')
+    parser.add_argument('-a', '--simulator-args', dest='simulator_args', action='store', nargs=argparse.REMAINDER,
+                        default=[], help='Additional simulator arguments')
+    parser.add_argument('-d', '--debug', action='store_true', help='Print debug messages to stderr')
+    args = parser.parse_args()
+
+    # Configure logging
+    _configure_logging(args.debug)
+
+    scenarios = [s for s in _get_scenarios(args.examples_dir) if fnmatch.fnmatch(s['name'], args.filter)]
+    if not scenarios:
+        logger.error('No scenario matches: %s' % args.filter)
+        exit(1)
+
+    results = {}
+    for scenario in scenarios:
+        logger.info('Running scenario: %s' % scenario['name'])
+        runs = [_run_scenario(args.simulator, scenario, args.simulator_args) for _ in range(args.repetitions)]
+        results[scenario['name']] = _merge_repetitions(runs)
+        result = results[scenario['name']]
+        if result['exit_code'] != 0:
+            logger.error('  failed with exit code %d' % result['exit_code'])
+        else:
+            logger.info('  wall time: %.2fs, peak RSS: %d KB, %.0f events/s, makespan: %.2fs'
+                        % (result['wall_time'], result['peak_rss'], result['events_per_second'],
+                           result['makespan']))
+
+    baseline = {}
+    if os.path.isfile(args.baseline):
+        with open(args.baseline) as f:
+            baseline = json.load(f)['scenarios']
+    else:
+        logger.warning('No baseline found at %s (use --update-baseline to create it)' % args.baseline)
+    comparison, regressions = _compare(results, baseline, args.tolerance, args.makespan_tolerance)
+
+    output = {
+        'date': datetime.datetime.now().isoformat(),
+        'host': platform.node(),
+        'simulator': os.path.abspath(args.simulator),
+        'scenarios': results,
+        'comparison': comparison,
+        'regressions': regressions
+    }
+    with open(args.output, 'w') as f:
+        json.dump(output, f, indent=2)
+    logger.info('Results written to: %s' % args.output)
+
+    if args.update_baseline:
+        failed = [name for name, result in results.items() if result['exit_code'] != 0]
+        if failed:
+            logger.error('Baseline not updated, scenarios failed: %s' % ', '.join(failed))
+            exit(1)
+        baseline.update(results)
+        with open(args.baseline, 'w') as f:
+            json.dump({'date': output['date'], 'host': output['host'], 'scenarios': baseline}, f, indent=2)
+        logger.info('Baseline written to: %s' % args.baseline)
+        return
+
+    for regression in regressions:
+        logger.error('Regression: %s' % regression)
+    if regressions:
+        exit(1)
+
+
+if __name__ == '__main__':
+    main()